@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "converter.h"
+#include "thread_pool.h"
+#include "xlsx_generator.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ============================ ڴͳ ============================
+
+/**
+ * ѷֵפڴ㣬ʹÿ״ķֵͳƣֻLinux֧֣ƽ̨ۼƷֵ
+ */
+void ResetPeakRss() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+uint64_t PeakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+    // VmHWMɱclear_refsãru_maxrss
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+    }
+    return 0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
+
+// ============================ ״ ============================
+
+/**
+ * Ԥ״ֱѹַַϡ̶Ⱥ͹
+ */
+std::vector<WorkbookShape> PresetShapes() {
+    std::vector<WorkbookShape> shapes;
+    auto add = [&](const char* name, size_t rows, size_t columns, double stringRatio, size_t distinct, double sparsity, size_t sheets) {
+        WorkbookShape shape;
+        shape.name = name;
+        shape.rows = rows;
+        shape.columns = columns;
+        shape.stringRatio = stringRatio;
+        shape.distinctStrings = distinct;
+        shape.sparsity = sparsity;
+        shape.sheets = sheets;
+        shapes.push_back(shape);
+    };
+    add("small",      200,    10, 0.5,   100, 0.0,  1);
+    add("tall",    200000,     8, 0.5,  5000, 0.0,  1);
+    add("wide",      5000,   200, 0.5,  5000, 0.0,  1);
+    add("numbers",  50000,    20, 0.0,     0, 0.0,  1);
+    add("strings",  50000,    20, 1.0, 200000, 0.0, 1);
+    add("sparse",   50000,    50, 0.5,  5000, 0.9,  1);
+    add("sheets",    5000,    10, 0.5,  1000, 0.0, 20);
+    return shapes;
+}
+
+// ============================ в ============================
+
+struct BenchOptions {
+    std::vector<std::string> shapeNames;
+    WorkbookShape custom;
+    bool useCustom = false;
+    double scale = 1.0;
+    size_t iterations = 7;
+    size_t jobs = 1;
+    fs::path workDir;
+    bool keep = false;
+    bool csv = false;
+};
+
+void PrintUsage() {
+    std::cout <<
+        "usage: xlsx2json-bench [options]\n"
+        "\n"
+        "  --shape <name>        run a preset shape (repeatable; default: all presets)\n"
+        "                        presets: small tall wide numbers strings sparse sheets\n"
+        "  --rows <n> --columns <n> --strings <ratio> --distinct <n> --sparsity <ratio> --sheets <n>\n"
+        "                        run one custom shape instead of the presets\n"
+        "  --scale <f>           multiply the row count of every shape (default: 1)\n"
+        "  -n, --iterations <n>  timed runs per shape after one warm-up (default: 7)\n"
+        "  -j, --jobs <n>        convert sheets on a pool of <n> threads (default: 1)\n"
+        "  --dir <dir>           where generated workbooks are written (default: temp dir)\n"
+        "  --keep                keep generated workbooks and outputs\n"
+        "  --csv                 print results as CSV\n"
+        "  -h, --help            show this help\n";
+}
+
+bool ParseArguments(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto needValue = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        auto customValue = [&](auto apply) {
+            const char* value = needValue();
+            if (!value) return false;
+            options.useCustom = true;
+            apply(value);
+            return true;
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            std::exit(0);
+        } else if (arg == "--shape") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.shapeNames.emplace_back(value);
+        } else if (arg == "--rows") {
+            if (!customValue([&](const char* v) { options.custom.rows = std::strtoull(v, nullptr, 10); })) return false;
+        } else if (arg == "--columns") {
+            if (!customValue([&](const char* v) { options.custom.columns = std::strtoull(v, nullptr, 10); })) return false;
+        } else if (arg == "--strings") {
+            if (!customValue([&](const char* v) { options.custom.stringRatio = std::strtod(v, nullptr); })) return false;
+        } else if (arg == "--distinct") {
+            if (!customValue([&](const char* v) { options.custom.distinctStrings = std::strtoull(v, nullptr, 10); })) return false;
+        } else if (arg == "--sparsity") {
+            if (!customValue([&](const char* v) { options.custom.sparsity = std::strtod(v, nullptr); })) return false;
+        } else if (arg == "--sheets") {
+            if (!customValue([&](const char* v) { options.custom.sheets = std::strtoull(v, nullptr, 10); })) return false;
+        } else if (arg == "--scale") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.scale = std::strtod(value, nullptr);
+        } else if (arg == "-n" || arg == "--iterations") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.iterations = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "-j" || arg == "--jobs") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.jobs = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "--dir") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.workDir = value;
+        } else if (arg == "--keep") {
+            options.keep = true;
+        } else if (arg == "--csv") {
+            options.csv = true;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================  ============================
+
+/**
+ * һ״Ĳ
+ */
+struct BenchResult {
+    WorkbookShape shape;
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+    size_t rows = 0;
+    double medianMs = 0;
+    double p95Ms = 0;
+    uint64_t peakRss = 0;
+};
+
+double Percentile(std::vector<double> values, double fraction) {
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(fraction * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+BenchResult RunShape(const WorkbookShape& shape, const BenchOptions& options, ThreadPool* pool) {
+    fs::path srcPath = options.workDir / (shape.name + ".xlsx");
+    fs::path desPath = options.workDir / (shape.name + ".json");
+    GenerateWorkbook(srcPath, shape);
+
+    ConvertOptions convert;
+    convert.allSheets = true;
+
+    BenchResult result;
+    result.shape = shape;
+
+    // תһԤļ棬ʱ
+    Xlsx2Json(srcPath, desPath, convert, ConvertCallbacks(), pool);
+
+    ResetPeakRss();
+    std::vector<double> times;
+    for (size_t i = 0; i < options.iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        ConvertResult converted = Xlsx2Json(srcPath, desPath, convert, ConvertCallbacks(), pool);
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        if (converted.failedSheets > 0) {
+            throw std::runtime_error("shape " + shape.name + ": " + std::to_string(converted.failedSheets) + " sheet(s) failed");
+        }
+        result.inputBytes = converted.inputBytes;
+        result.outputBytes = converted.outputBytes;
+        result.rows = converted.rows;
+    }
+    result.peakRss = PeakRssBytes();
+    result.medianMs = Percentile(times, 0.5);
+    result.p95Ms = Percentile(times, 0.95);
+
+    if (!options.keep) {
+        std::error_code ec;
+        fs::remove(srcPath, ec);
+        for (size_t s = 0; s < shape.sheets; ++s) {
+            fs::remove(SheetOutputPath(desPath, "Sheet" + std::to_string(s + 1)), ec);
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<WorkbookShape> shapes;
+    if (options.useCustom) {
+        options.custom.name = "custom";
+        shapes.push_back(options.custom);
+    } else {
+        auto presets = PresetShapes();
+        if (options.shapeNames.empty()) {
+            shapes = presets;
+        }
+        for (auto& name : options.shapeNames) {
+            auto found = std::find_if(presets.begin(), presets.end(), [&](const WorkbookShape& shape) { return shape.name == name; });
+            if (found == presets.end()) {
+                std::cerr << "unknown shape: " << name << std::endl;
+                return 2;
+            }
+            shapes.push_back(*found);
+        }
+    }
+    for (auto& shape : shapes) {
+        shape.rows = std::max<size_t>(1, static_cast<size_t>(shape.rows * options.scale));
+    }
+
+    if (options.workDir.empty()) {
+        options.workDir = fs::temp_directory_path() / "xlsx2json-bench";
+    }
+    fs::create_directories(options.workDir);
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.jobs > 1) pool = std::make_unique<ThreadPool>(options.jobs);
+
+    if (options.csv) {
+        std::printf("shape,rows,columns,strings,distinct,sparsity,sheets,input_bytes,output_bytes,median_ms,p95_ms,rows_per_s,peak_rss_bytes\n");
+    } else {
+        std::printf("%-10s %9s %7s %6s %10s %10s %10s %10s %12s %10s\n",
+            "shape", "rows", "sheets", "str%", "input MB", "output MB", "median ms", "p95 ms", "rows/s", "peak MB");
+    }
+
+    const double mb = 1024.0 * 1024.0;
+    for (auto& shape : shapes) {
+        BenchResult result;
+        try {
+            result = RunShape(shape, options, pool.get());
+        } catch (const std::exception& e) {
+            std::cerr << "shape " << shape.name << ": " << e.what() << std::endl;
+            return 1;
+        }
+
+        double rowsPerSecond = result.medianMs > 0 ? result.rows / (result.medianMs / 1000) : 0;
+        if (options.csv) {
+            std::printf("%s,%zu,%zu,%.2f,%zu,%.2f,%zu,%llu,%llu,%.3f,%.3f,%.0f,%llu\n",
+                shape.name.c_str(), shape.rows, shape.columns, shape.stringRatio, shape.distinctStrings, shape.sparsity, shape.sheets,
+                static_cast<unsigned long long>(result.inputBytes), static_cast<unsigned long long>(result.outputBytes),
+                result.medianMs, result.p95Ms, rowsPerSecond, static_cast<unsigned long long>(result.peakRss));
+        } else {
+            std::printf("%-10s %9zu %7zu %5.0f%% %10.1f %10.1f %10.1f %10.1f %12.0f %10.1f\n",
+                shape.name.c_str(), result.rows, shape.sheets, shape.stringRatio * 100,
+                result.inputBytes / mb, result.outputBytes / mb, result.medianMs, result.p95Ms, rowsPerSecond, result.peakRss / mb);
+        }
+        std::fflush(stdout);
+    }
+    return 0;
+}
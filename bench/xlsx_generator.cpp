@@ -0,0 +1,280 @@
+#include "xlsx_generator.h"
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+// ====== Zip д ======
+
+/**
+ * ֻдСzipdeflateѹ֧zip64ɲõĹ
+ */
+class ZipWriter {
+public:
+    explicit ZipWriter(const std::filesystem::path& path) : file(path, std::ios::binary), offset(0) {
+        if (!file) {
+            throw std::runtime_error("cannot create " + path.string());
+        }
+    }
+
+    void add(const std::string& name, const std::string& data) {
+        Entry entry;
+        entry.name = name;
+        entry.crc = crc32(0, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()));
+        entry.size = static_cast<uint32_t>(data.size());
+        entry.offset = offset;
+
+        std::string compressed = deflateRaw(data);
+        entry.compressedSize = static_cast<uint32_t>(compressed.size());
+
+        std::string header;
+        put32(header, 0x04034b50);
+        put16(header, 20);
+        put16(header, 0);
+        put16(header, 8);
+        put16(header, 0);
+        put16(header, 0);
+        put32(header, entry.crc);
+        put32(header, entry.compressedSize);
+        put32(header, entry.size);
+        put16(header, static_cast<uint16_t>(name.size()));
+        put16(header, 0);
+        header += name;
+        write(header);
+        write(compressed);
+        entries.push_back(entry);
+    }
+
+    void finish() {
+        uint32_t directoryOffset = offset;
+        for (auto& entry : entries) {
+            std::string record;
+            put32(record, 0x02014b50);
+            put16(record, 20);
+            put16(record, 20);
+            put16(record, 0);
+            put16(record, 8);
+            put16(record, 0);
+            put16(record, 0);
+            put32(record, entry.crc);
+            put32(record, entry.compressedSize);
+            put32(record, entry.size);
+            put16(record, static_cast<uint16_t>(entry.name.size()));
+            put16(record, 0);
+            put16(record, 0);
+            put16(record, 0);
+            put16(record, 0);
+            put32(record, 0);
+            put32(record, entry.offset);
+            record += entry.name;
+            write(record);
+        }
+
+        std::string end;
+        put32(end, 0x06054b50);
+        put16(end, 0);
+        put16(end, 0);
+        put16(end, static_cast<uint16_t>(entries.size()));
+        put16(end, static_cast<uint16_t>(entries.size()));
+        put32(end, offset - directoryOffset);
+        put32(end, directoryOffset);
+        put16(end, 0);
+        write(end);
+        file.close();
+        if (!file) {
+            throw std::runtime_error("zip: write failed");
+        }
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        uint32_t crc = 0;
+        uint32_t size = 0;
+        uint32_t compressedSize = 0;
+        uint32_t offset = 0;
+    };
+
+    static void put16(std::string& out, uint16_t value) {
+        out += static_cast<char>(value & 0xFF);
+        out += static_cast<char>(value >> 8);
+    }
+
+    static void put32(std::string& out, uint32_t value) {
+        put16(out, static_cast<uint16_t>(value & 0xFFFF));
+        put16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    static std::string deflateRaw(const std::string& data) {
+        z_stream stream{};
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("zip: deflateInit2 failed");
+        }
+        std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        int status = deflate(&stream, Z_FINISH);
+        deflateEnd(&stream);
+        if (status != Z_STREAM_END) {
+            throw std::runtime_error("zip: deflate failed");
+        }
+        out.resize(stream.total_out);
+        return out;
+    }
+
+    void write(const std::string& data) {
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        offset += static_cast<uint32_t>(data.size());
+    }
+
+    std::ofstream file;
+    uint32_t offset;
+    std::vector<Entry> entries;
+};
+
+// ======  ======
+
+std::string ColumnName(size_t column) {
+    std::string name;
+    for (++column; column > 0; column = (column - 1) / 26) {
+        name.insert(name.begin(), static_cast<char>('A' + (column - 1) % 26));
+    }
+    return name;
+}
+
+/**
+ * indexַÿģGBKתķASCII·
+ */
+std::string SharedString(size_t index) {
+    std::string text = "item_" + std::to_string(index);
+    if (index % 3 == 0) text += " \xE4\xB8\xAD\xE6\x96\x87";      // ""
+    if (index % 7 == 0) text += " <&>";
+    return text;
+}
+
+std::string EscapeXml(const std::string& text) {
+    std::string out;
+    for (char ch : text) {
+        switch (ch) {
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '&': out += "&amp;"; break;
+        default: out += ch; break;
+        }
+    }
+    return out;
+}
+
+std::string SheetXml(const WorkbookShape& shape, size_t sheetIndex, size_t headerBase) {
+    std::mt19937 random(shape.seed * 7919u + static_cast<uint32_t>(sheetIndex));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> pick(0, shape.distinctStrings > 0 ? shape.distinctStrings - 1 : 0);
+
+    std::string xml;
+    xml.reserve((shape.rows + 1) * shape.columns * 24);
+    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+           "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">";
+    xml += "<dimension ref=\"A1:" + ColumnName(shape.columns - 1) + std::to_string(shape.rows + 1) + "\"/>";
+    xml += "<sheetData>";
+
+    // ͷùַĩβ c1..cN
+    xml += "<row r=\"1\">";
+    for (size_t c = 0; c < shape.columns; ++c) {
+        xml += "<c r=\"" + ColumnName(c) + "1\" t=\"s\"><v>" + std::to_string(headerBase + c) + "</v></c>";
+    }
+    xml += "</row>";
+
+    for (size_t r = 0; r < shape.rows; ++r) {
+        std::string rowNumber = std::to_string(r + 2);
+        xml += "<row r=\"" + rowNumber + "\">";
+        for (size_t c = 0; c < shape.columns; ++c) {
+            if (unit(random) < shape.sparsity) continue;
+            xml += "<c r=\"" + ColumnName(c) + rowNumber + "\"";
+            if (shape.distinctStrings > 0 && unit(random) < shape.stringRatio) {
+                xml += " t=\"s\"><v>" + std::to_string(pick(random)) + "</v></c>";
+            } else if (random() % 2 == 0) {
+                xml += "><v>" + std::to_string(random() % 100000) + "</v></c>";
+            } else {
+                xml += "><v>" + std::to_string((random() % 1000000) / 100.0) + "</v></c>";
+            }
+        }
+        xml += "</row>";
+    }
+    xml += "</sheetData></worksheet>";
+    return xml;
+}
+
+} // namespace
+
+void GenerateWorkbook(const std::filesystem::path& path, const WorkbookShape& shape) {
+    if (shape.columns == 0 || shape.sheets == 0) {
+        throw std::runtime_error("shape " + shape.name + ": columns and sheets must be positive");
+    }
+
+    ZipWriter zip(path);
+
+    std::string types =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>";
+    for (size_t s = 0; s < shape.sheets; ++s) {
+        types += "<Override PartName=\"/xl/worksheets/sheet" + std::to_string(s + 1) +
+            ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    types += "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
+             "</Types>";
+    zip.add("[Content_Types].xml", types);
+
+    zip.add("_rels/.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>");
+
+    std::string workbook =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><sheets>";
+    std::string rels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+    for (size_t s = 0; s < shape.sheets; ++s) {
+        std::string id = std::to_string(s + 1);
+        workbook += "<sheet name=\"Sheet" + id + "\" sheetId=\"" + id + "\" r:id=\"rId" + id + "\"/>";
+        rels += "<Relationship Id=\"rId" + id + "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" "
+                "Target=\"worksheets/sheet" + id + ".xml\"/>";
+    }
+    workbook += "</sheets></workbook>";
+    rels += "<Relationship Id=\"rId" + std::to_string(shape.sheets + 1) +
+            "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+            "</Relationships>";
+    zip.add("xl/workbook.xml", workbook);
+    zip.add("xl/_rels/workbook.xml.rels", rels);
+
+    for (size_t s = 0; s < shape.sheets; ++s) {
+        zip.add("xl/worksheets/sheet" + std::to_string(s + 1) + ".xml", SheetXml(shape, s, shape.distinctStrings));
+    }
+
+    size_t total = shape.distinctStrings + shape.columns;
+    std::string strings =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"" + std::to_string(total) +
+        "\" uniqueCount=\"" + std::to_string(total) + "\">";
+    for (size_t i = 0; i < shape.distinctStrings; ++i) {
+        strings += "<si><t>" + EscapeXml(SharedString(i)) + "</t></si>";
+    }
+    for (size_t c = 0; c < shape.columns; ++c) {
+        strings += "<si><t>c" + std::to_string(c + 1) + "</t></si>";
+    }
+    strings += "</sst>";
+    zip.add("xl/sharedStrings.xml", strings);
+
+    zip.finish();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// ============================ ϳɹ ============================
+
+/**
+ * ɵĹ״һΪͷ c1..cNΪ
+ */
+struct WorkbookShape {
+    std::string name;
+    size_t rows = 1000;             // ͷ
+    size_t columns = 10;
+    double stringRatio = 0.5;       // ǿյԪַռΪ
+    size_t distinctStrings = 1000;  // ַĸsharedStrings.xmlĴС븴ó̶
+    double sparsity = 0.0;          // յԪյԪд<c>
+    size_t sheets = 1;
+    uint32_t seed = 1;
+};
+
+/**
+ * ״xlsxֻ״Ӿͬһ״ÿɵļͬ
+ */
+void GenerateWorkbook(const std::filesystem::path& path, const WorkbookShape& shape);
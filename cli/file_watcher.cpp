@@ -0,0 +1,198 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+void FileWatcher::touch(const fs::path& path) {
+    pending[path] = Clock::now();
+}
+
+std::vector<fs::path> FileWatcher::takeSettled(Clock::time_point now) {
+    std::vector<fs::path> settled;
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (now - it->second >= debounce) {
+            settled.push_back(it->first);
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return settled;
+}
+
+#ifdef __linux__
+
+// ====== inotify ======
+
+struct FileWatcher::Platform {
+    int fd = -1;
+    std::unordered_map<int, std::pair<fs::path, bool>> watches;   // wd -> Ŀ¼, Ƿݹ
+};
+
+FileWatcher::FileWatcher(std::chrono::milliseconds debounce)
+    : debounce(debounce), platform(std::make_unique<Platform>()) {
+    platform->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (platform->fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "inotify_init1");
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (platform->fd >= 0) close(platform->fd);
+}
+
+void FileWatcher::addDirectory(const fs::path& directory, bool recursive) {
+    // ֻдرպ͸ʱļдеIN_MODIFYش
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+    int wd = inotify_add_watch(platform->fd, directory.c_str(), mask);
+    if (wd < 0) {
+        throw std::system_error(errno, std::generic_category(), "inotify_add_watch " + directory.string());
+    }
+    platform->watches[wd] = { directory, recursive };
+
+    if (!recursive) return;
+    std::error_code ec;
+    for (auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_directory(ec) && !entry.is_symlink(ec)) addDirectory(entry.path(), true);
+    }
+}
+
+std::vector<fs::path> FileWatcher::wait() {
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    for (;;) {
+        auto now = Clock::now();
+        auto settled = takeSettled(now);
+        if (!settled.empty()) return settled;
+
+        // ûдļʱһֱȣȵһڽ
+        int timeout = -1;
+        for (auto& [path, last] : pending) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(last + debounce - now).count() + 1;
+            if (timeout < 0 || left < timeout) timeout = static_cast<int>(left);
+        }
+
+        pollfd pfd{ platform->fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "poll");
+        }
+        if (ready == 0) continue;
+
+        for (;;) {
+            ssize_t length = read(platform->fd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+
+            for (char* p = buffer; p < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                auto it = platform->watches.find(event->wd);
+                if (it == platform->watches.end()) continue;
+                if (event->mask & IN_IGNORED) {
+                    platform->watches.erase(it);
+                    continue;
+                }
+                if (event->len == 0) continue;
+
+                fs::path path = it->second.first / event->name;
+                bool recursive = it->second.second;
+                if (event->mask & IN_ISDIR) {
+                    // ½Ŀ¼ϼӣеļձ
+                    if (recursive && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        try {
+                            addDirectory(path, true);
+                        } catch (const std::system_error&) {
+                            continue;   // սֱɾʱĿ¼
+                        }
+                        std::error_code ec;
+                        for (auto& entry : fs::recursive_directory_iterator(path, ec)) {
+                            if (entry.is_regular_file(ec)) touch(entry.path());
+                        }
+                    }
+                } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    touch(path);
+                }
+            }
+        }
+    }
+}
+
+#else
+
+// ====== ѯ ======
+
+struct FileWatcher::Platform {
+    struct Stamp {
+        fs::file_time_type modified;
+        uintmax_t size = 0;
+    };
+
+    std::vector<std::pair<fs::path, bool>> directories;
+    std::map<fs::path, Stamp> stamps;
+
+    // ɨһĿ¼³ֻ޸ʱ䡢С仯ļ
+    std::vector<fs::path> scan() {
+        std::map<fs::path, Stamp> current;
+        std::error_code ec;
+        auto record = [&](const fs::directory_entry& entry) {
+            if (!entry.is_regular_file(ec)) return;
+            current[entry.path()] = Stamp{ entry.last_write_time(ec), entry.file_size(ec) };
+        };
+        for (auto& [directory, recursive] : directories) {
+            if (recursive) {
+                for (auto& entry : fs::recursive_directory_iterator(directory, ec)) record(entry);
+            } else {
+                for (auto& entry : fs::directory_iterator(directory, ec)) record(entry);
+            }
+        }
+
+        std::vector<fs::path> changed;
+        for (auto& [path, stamp] : current) {
+            auto it = stamps.find(path);
+            if (it == stamps.end() || it->second.modified != stamp.modified || it->second.size != stamp.size) {
+                changed.push_back(path);
+            }
+        }
+        stamps.swap(current);
+        return changed;
+    }
+};
+
+FileWatcher::FileWatcher(std::chrono::milliseconds debounce)
+    : debounce(debounce), platform(std::make_unique<Platform>()) {
+}
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::addDirectory(const fs::path& directory, bool recursive) {
+    platform->directories.emplace_back(directory, recursive);
+    platform->scan();
+}
+
+std::vector<fs::path> FileWatcher::wait() {
+    // ѯȡڵһ룬ɺԼ1.5ھܷ
+    auto interval = std::max(debounce / 2, std::chrono::milliseconds(10));
+    for (;;) {
+        for (auto& path : platform->scan()) touch(path);
+        auto settled = takeSettled(Clock::now());
+        if (!settled.empty()) return settled;
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <vector>
+
+// ============================ Ŀ¼ ============================
+
+/**
+ * Ŀ¼ļд
+ * Linuxʹinotifyƽ̨ʱȽ޸ʱʹС
+ * ExcelLibreOfficeʱд͸ͬһ·debounceʱû¼㱣
+ */
+class FileWatcher {
+public:
+    explicit FileWatcher(std::chrono::milliseconds debounce);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // recursiveʱͬʱкԺ½Ŀ¼
+    void addDirectory(const std::filesystem::path& directory, bool recursive);
+
+    // ֱļɣЩļ·
+    std::vector<std::filesystem::path> wait();
+
+private:
+    struct Platform;
+
+    void touch(const std::filesystem::path& path);
+    std::vector<std::filesystem::path> takeSettled(std::chrono::steady_clock::time_point now);
+
+    std::chrono::milliseconds debounce;
+    std::map<std::filesystem::path, std::chrono::steady_clock::time_point> pending;
+    std::unique_ptr<Platform> platform;
+};
@@ -0,0 +1,544 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <filesystem>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include "converter.h"
+#include "conversion_cache.h"
+#include "thread_pool.h"
+#include "file_watcher.h"
+#include "trace.h"
+
+namespace fs = std::filesystem;
+
+// ============================ в ============================
+
+/**
+ * ѡ
+ */
+struct CliOptions {
+    std::vector<std::string> inputs;
+    fs::path outputDir;
+    size_t jobs = std::thread::hardware_concurrency();
+    bool quiet = false;
+    bool useCache = true;
+    bool force = false;
+    bool watch = false;
+    bool stats = false;
+    fs::path tracePath;
+    std::chrono::milliseconds debounce{ 50 };
+    fs::path manifestPath;
+    ConvertOptions convert;
+};
+
+void PrintUsage() {
+    std::cout <<
+        "usage: xlsx2json-cli [options] <input>...\n"
+        "\n"
+        "  <input>               xlsx file, directory (searched recursively) or glob;\n"
+        "                        '*' and '?' stay inside one directory, '**' spans directories\n"
+        "  -o, --output <dir>    write outputs under <dir>, mirroring the input layout\n"
+        "                        (default: next to each source file)\n"
+        "  -j, --jobs <n>        number of worker threads (default: hardware threads)\n"
+        "  -a, --all-sheets      convert every sheet to <name>_<sheet>.json\n"
+        "  -s, --sheets <a,b>    convert only the listed sheets (implies --all-sheets)\n"
+        "  -t, --typed           write numbers and booleans as JSON values and empty\n"
+        "                        cells as null instead of strings\n"
+        "      --omit-empty      leave out the keys of empty cells\n"
+        "      --raw             write stored cell values without applying number\n"
+        "                        formats; styles.xml is not read\n"
+        "      --compact         write JSON without whitespace\n"
+        "      --ndjson          write one row object per line to <name>.ndjson\n"
+        "      --shape <shape>   objects: an array with one object per row (default)\n"
+        "                        rows: {\"columns\":[keys],\"rows\":[[values],...]}\n"
+        "                        columns: {\"columns\":[keys],\"data\":{key:[values],...}}\n"
+        "  -k, --key <column>    write rows into an object keyed by <column>; a sheet\n"
+        "                        with a missing or duplicate key fails\n"
+        "      --format <format> json (default), msgpack or cbor; binary outputs are\n"
+        "                        typed, UTF-8 and deduplicate repeated strings\n"
+        "  -q, --quiet           only print errors and the summary\n"
+        "      --stats           print time, bytes and throughput of every conversion stage\n"
+        "      --trace <file>    record a Chrome/Perfetto trace of every thread to <file>\n"
+        "  -f, --force           convert every file even if it is up to date\n"
+        "      --no-cache        neither read nor write the manifest\n"
+        "      --manifest <file> manifest recording converted files\n"
+        "                        (default: .xlsx2json.manifest in the output directory,\n"
+        "                        or in the current directory without --output)\n"
+        "  -w, --watch           keep running and reconvert workbooks when they are saved\n"
+        "      --debounce <ms>   quiet period after the last write before a saved file\n"
+        "                        is converted in watch mode (default: 50)\n"
+        "  -h, --help            show this help\n";
+}
+
+/**
+ * ʱfalse
+ */
+bool ParseArguments(int argc, char* argv[], CliOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto needValue = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            std::exit(0);
+        } else if (arg == "-o" || arg == "--output") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.outputDir = value;
+        } else if (arg == "-j" || arg == "--jobs") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.jobs = std::strtoul(value, nullptr, 10);
+            if (options.jobs == 0) {
+                std::cerr << "invalid job count: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "-a" || arg == "--all-sheets") {
+            options.convert.allSheets = true;
+        } else if (arg == "-s" || arg == "--sheets") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.convert.allSheets = true;
+            options.convert.sheets = ParseSheetList(value);
+        } else if (arg == "-t" || arg == "--typed") {
+            options.convert.typedValues = true;
+        } else if (arg == "--omit-empty") {
+            options.convert.omitEmpty = true;
+        } else if (arg == "--raw") {
+            options.convert.rawValues = true;
+        } else if (arg == "--compact") {
+            options.convert.layout = JsonLayout::Compact;
+        } else if (arg == "--ndjson") {
+            options.convert.layout = JsonLayout::Lines;
+        } else if (arg == "-k" || arg == "--key") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.convert.keyColumn = value;
+        } else if (arg == "--shape") {
+            const char* value = needValue();
+            if (!value) return false;
+            std::string_view shape = value;
+            if (shape == "objects") {
+                options.convert.shape = TableShape::Objects;
+            } else if (shape == "rows") {
+                options.convert.shape = TableShape::Rows;
+            } else if (shape == "columns") {
+                options.convert.shape = TableShape::Columns;
+            } else {
+                std::cerr << "unknown shape: " << shape << std::endl;
+                return false;
+            }
+        } else if (arg == "--format") {
+            const char* value = needValue();
+            if (!value) return false;
+            std::string_view format = value;
+            if (format == "json") {
+                options.convert.format = OutputFormat::Json;
+            } else if (format == "msgpack") {
+                options.convert.format = OutputFormat::MessagePack;
+            } else if (format == "cbor") {
+                options.convert.format = OutputFormat::Cbor;
+            } else {
+                std::cerr << "unknown format: " << format << std::endl;
+                return false;
+            }
+        } else if (arg == "-q" || arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--trace") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.tracePath = value;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "-f" || arg == "--force") {
+            options.force = true;
+        } else if (arg == "-w" || arg == "--watch") {
+            options.watch = true;
+        } else if (arg == "--debounce") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.debounce = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--no-cache") {
+            options.useCache = false;
+        } else if (arg == "--manifest") {
+            const char* value = needValue();
+            if (!value) return false;
+            options.manifestPath = value;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return false;
+        } else {
+            options.inputs.emplace_back(arg);
+        }
+    }
+
+    if (options.inputs.empty()) {
+        std::cerr << "no input given" << std::endl;
+        return false;
+    }
+    if (options.convert.shape == TableShape::Columns && options.convert.layout == JsonLayout::Lines) {
+        std::cerr << "--shape columns cannot be combined with --ndjson" << std::endl;
+        return false;
+    }
+    if (!options.convert.keyColumn.empty() &&
+        (options.convert.shape == TableShape::Columns || options.convert.layout == JsonLayout::Lines)) {
+        std::cerr << "--key cannot be combined with --shape columns or --ndjson" << std::endl;
+        return false;
+    }
+    if (options.convert.format != OutputFormat::Json &&
+        (options.convert.shape == TableShape::Columns || options.convert.layout == JsonLayout::Lines)) {
+        std::cerr << "--format msgpack/cbor cannot be combined with --shape columns or --ndjson" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================ չ ============================
+
+/**
+ * תļrelativeΪĿ¼·Ŀ¼иĿ¼ṹ
+ */
+struct InputFile {
+    fs::path path;
+    fs::path relative;
+};
+
+bool HasWildcard(std::string_view text) {
+    return text.find_first_of("*?") != std::string_view::npos;
+}
+
+/**
+ * ͨƥ䣺'*''?'Խ'/''**'ƥĿ¼
+ */
+bool GlobMatch(std::string_view pattern, std::string_view text) {
+    while (!pattern.empty()) {
+        if (pattern.substr(0, 2) == "**") {
+            std::string_view rest = pattern.substr(2);
+            if (!rest.empty() && rest[0] == '/' && GlobMatch(rest.substr(1), text)) return true;
+            for (size_t i = 0; i <= text.size(); ++i) {
+                if (GlobMatch(rest, text.substr(i))) return true;
+            }
+            return false;
+        }
+        if (pattern[0] == '*') {
+            for (size_t i = 0; i <= text.size(); ++i) {
+                if (GlobMatch(pattern.substr(1), text.substr(i))) return true;
+                if (i < text.size() && text[i] == '/') break;
+            }
+            return false;
+        }
+        if (text.empty()) return false;
+        if (pattern[0] == '?' ? text[0] == '/' : pattern[0] != text[0]) return false;
+        pattern.remove_prefix(1);
+        text.remove_prefix(1);
+    }
+    return text.empty();
+}
+
+/**
+ * Excelļʱɵ ~$name.xlsx ļǹ
+ */
+bool IsWorkbookFile(const fs::path& path) {
+    return path.extension() == ".xlsx" && path.filename().string().rfind("~$", 0) != 0;
+}
+
+/**
+ * һļϣbase·ƥpatternxlsx
+ * ļʱexactΪtruepatternļĿ¼ʱpatternΪգʾȫxlsx
+ */
+struct InputSpec {
+    fs::path base;
+    std::string pattern;
+    bool recursive = false;
+    bool exact = false;
+};
+
+/**
+ * ļĿ¼ݹxlsxͨ
+ */
+bool ParseInput(const std::string& input, InputSpec& spec) {
+    std::string pattern = fs::path(input).generic_string();
+
+    if (!HasWildcard(pattern)) {
+        fs::path path(input);
+        if (fs::is_directory(path)) {
+            spec = InputSpec{ path, "", true, false };
+        } else if (fs::is_regular_file(path)) {
+            fs::path parent = path.parent_path();
+            spec = InputSpec{ parent.empty() ? fs::path(".") : parent, PathToUtf8(path.filename()), false, true };
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // һͨĿ¼֮ǰĲΪĿ¼
+    size_t wildcard = pattern.find_first_of("*?");
+    size_t slash = pattern.rfind('/', wildcard);
+    fs::path base = slash == std::string::npos ? fs::path(".") : fs::path(pattern.substr(0, slash + 1));
+    std::string rest = slash == std::string::npos ? pattern : pattern.substr(slash + 1);
+    if (!fs::is_directory(base)) return false;
+
+    spec = InputSpec{ base, rest, rest.find('/') != std::string::npos, false };
+    return true;
+}
+
+/**
+ * pathǷڸ룬ʱԸĿ¼·
+ */
+bool MatchInput(const InputSpec& spec, const fs::path& path, fs::path& relative) {
+    if (!IsWorkbookFile(path)) return false;
+    relative = path.lexically_relative(spec.base);
+    std::string text = relative.generic_string();
+    if (text.empty() || text.rfind("..", 0) == 0) return false;
+
+    if (spec.exact) return relative == PathFromUtf8(spec.pattern);
+    if (spec.pattern.empty()) return spec.recursive || text.find('/') == std::string::npos;
+    return GlobMatch(spec.pattern, text);
+}
+
+/**
+ * һչΪļб
+ */
+void ExpandInput(const InputSpec& spec, std::vector<InputFile>& files) {
+    if (spec.exact) {
+        fs::path relative = PathFromUtf8(spec.pattern);
+        files.push_back(InputFile{ spec.base == "." ? relative : spec.base / relative, relative });
+        return;
+    }
+
+    auto consider = [&](const fs::directory_entry& entry) {
+        fs::path relative;
+        if (entry.is_regular_file() && MatchInput(spec, entry.path(), relative)) {
+            files.push_back(InputFile{ entry.path(), relative });
+        }
+    };
+
+    if (spec.recursive) {
+        for (auto& entry : fs::recursive_directory_iterator(spec.base)) consider(entry);
+    } else {
+        for (auto& entry : fs::directory_iterator(spec.base)) consider(entry);
+    }
+}
+
+// ============================  ============================
+
+int main(int argc, char* argv[]) {
+    CliOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    if (!options.tracePath.empty()) {
+        Trace::start();
+        Trace::setThreadName("main");
+    }
+
+    std::vector<InputSpec> specs;
+    std::vector<InputFile> files;
+    for (auto& input : options.inputs) {
+        InputSpec spec;
+        if (!ParseInput(input, spec)) {
+            std::cerr << "not found: " << input << std::endl;
+            continue;
+        }
+        ExpandInput(spec, files);
+        specs.push_back(std::move(spec));
+    }
+
+    // ͬһļƥʱֻתһ
+    std::set<fs::path> seen;
+    std::vector<InputFile> unique;
+    for (auto& file : files) {
+        if (seen.insert(fs::weakly_canonical(file.path)).second) unique.push_back(std::move(file));
+    }
+    files.swap(unique);
+
+    if (files.empty() && !options.watch) {
+        std::cerr << "no xlsx files matched" << std::endl;
+        return 1;
+    }
+
+    std::mutex printMutex;
+    auto print = [&](std::ostream& stream, const std::string& line) {
+        std::lock_guard<std::mutex> lock(printMutex);
+        stream << line << '\n';
+    };
+
+    ConvertCallbacks callbacks;
+    callbacks.onSheetError = [&](const std::string& sheet, const std::string& error) {
+        print(std::cerr, "  sheet " + sheet + ": " + error);
+    };
+    callbacks.onSheetMissing = [&](const std::string& sheet) {
+        print(std::cerr, "  sheet not found: " + sheet);
+    };
+
+    // Դļѡûļֱ--forceʱճתˢ嵥
+    std::unique_ptr<ConversionManifest> manifest;
+    if (options.useCache) {
+        fs::path manifestPath = options.manifestPath;
+        if (manifestPath.empty()) {
+            manifestPath = (options.outputDir.empty() ? fs::path(".") : options.outputDir) / ".xlsx2json.manifest";
+        }
+        manifest = std::make_unique<ConversionManifest>(manifestPath);
+    }
+    const std::string optionsKey = ConvertOptionsKey(options.convert);
+
+    std::atomic<size_t> converted(0);
+    std::atomic<size_t> skipped(0);
+    std::atomic<size_t> failed(0);
+    std::atomic<size_t> sheets(0);
+    std::atomic<size_t> reusedSheets(0);
+    std::atomic<size_t> rows(0);
+    std::atomic<uint64_t> inputBytes(0);
+    std::atomic<uint64_t> outputBytes(0);
+    ConvertResult totals;
+    std::mutex totalsMutex;
+
+    ThreadPool pool(options.jobs);
+    auto start = std::chrono::steady_clock::now();
+
+    auto convertFile = [&](const InputFile& file) {
+        fs::path desPath;
+        if (options.outputDir.empty()) {
+            desPath = changeFileExtension(file.path, OutputExtension(options.convert));
+        } else {
+            desPath = changeFileExtension(options.outputDir / file.relative, OutputExtension(options.convert));
+        }
+
+        TraceScope trace("file", "cli", file.path);
+        auto fileStart = std::chrono::steady_clock::now();
+        try {
+            ConversionManifest::SourceState state;
+            if (manifest) {
+                state = ConversionManifest::sourceState(file.path);
+                if (!options.force && manifest->isUpToDate(file.path, optionsKey, state)) {
+                    ++skipped;
+                    if (!options.quiet) print(std::cout, "skip " + PathToUtf8(file.path) + " (up to date)");
+                    return;
+                }
+            }
+
+            // ʱȽָƣûĹĹϴε
+            ConvertCallbacks fileCallbacks = callbacks;
+            if (manifest && !options.force) {
+                fileCallbacks.canReuseSheet = [&](const std::string&, const fs::path& output, uint64_t fingerprint) {
+                    return manifest->canReuseOutput(file.path, optionsKey, output, fingerprint);
+                };
+            }
+
+            if (desPath.has_parent_path()) fs::create_directories(desPath.parent_path());
+            ConvertResult result = Xlsx2Json(file.path, desPath, options.convert, fileCallbacks, &pool);
+
+            sheets += result.sheets;
+            reusedSheets += result.reusedSheets;
+            rows += result.rows;
+            inputBytes += result.inputBytes;
+            outputBytes += result.outputBytes;
+            {
+                std::lock_guard<std::mutex> lock(totalsMutex);
+                totals.rows += result.rows;
+                totals.inputBytes += result.inputBytes;
+                totals.outputBytes += result.outputBytes;
+                totals.stats.merge(result.stats);
+            }
+            if (result.failedSheets > 0) {
+                ++failed;
+                if (manifest) manifest->remove(file.path);
+                print(std::cerr, "FAIL " + PathToUtf8(file.path) + ": " + std::to_string(result.failedSheets) + " sheet(s) failed");
+                return;
+            }
+            ++converted;
+            if (manifest) manifest->update(file.path, optionsKey, state, result.outputs);
+
+            if (!options.quiet) {
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fileStart).count();
+                char line[96];
+                if (result.reusedSheets > 0) {
+                    std::snprintf(line, sizeof(line), " (%zu rows, %zu of %zu sheets unchanged, %.1f ms)",
+                        result.rows, result.reusedSheets, result.sheets, ms);
+                } else {
+                    std::snprintf(line, sizeof(line), " (%zu rows, %.1f ms)", result.rows, ms);
+                }
+                print(std::cout, "ok   " + PathToUtf8(file.path) + " -> " + PathToUtf8(desPath) + line);
+                if (options.stats) print(std::cout, "     " + FormatConvertStats(result));
+            }
+        } catch (const std::exception& e) {
+            ++failed;
+            if (manifest) manifest->remove(file.path);
+            print(std::cerr, "FAIL " + PathToUtf8(file.path) + ": " + e.what());
+        }
+    };
+
+    // ÿתд嵥٣ʱ̶߳ѿ
+    auto saveAfterBatch = [&]() {
+        try {
+            if (manifest) manifest->save();
+            if (!options.tracePath.empty()) Trace::writeJson(options.tracePath);
+        } catch (const std::exception& e) {
+            print(std::cerr, std::string("cannot save: ") + e.what());
+        }
+    };
+
+    pool.parallelFor(files.size(), [&](size_t i) { convertFile(files[i]); });
+    saveAfterBatch();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double safeSeconds = seconds > 0 ? seconds : 1e-9;
+    double inputMB = inputBytes / (1024.0 * 1024.0);
+    double outputMB = outputBytes / (1024.0 * 1024.0);
+
+    std::printf("\n%zu converted, %zu up to date, %zu failed, %zu sheets (%zu unchanged), %zu rows in %.2f s on %zu threads\n",
+        converted.load(), skipped.load(), failed.load(), sheets.load(), reusedSheets.load(), rows.load(), seconds, pool.size());
+    std::printf("%.1f files/s, %.1f MB/s in (%.1f MB), %.1f MB/s out (%.1f MB)\n",
+        files.size() / safeSeconds, inputMB / safeSeconds, inputMB, outputMB / safeSeconds, outputMB);
+    if (options.stats) {
+        // ׶κʱļ̵߳ۼƣǽʱȽϿɿһƿ
+        totals.stats.totalSeconds = seconds;
+        std::printf("stages (summed over threads): %s\n", FormatConvertStats(totals).c_str());
+    }
+
+    if (!options.watch) {
+        return failed > 0 ? 1 : 0;
+    }
+
+    // Ŀ¼ɵļԭ·ӳתֱֹ̱
+    FileWatcher watcher(options.debounce);
+    for (auto& spec : specs) {
+        watcher.addDirectory(spec.base, spec.recursive);
+    }
+    std::cout << "watching " << specs.size() << " input(s), press Ctrl+C to stop" << std::endl;
+
+    for (;;) {
+        std::vector<InputFile> changed;
+        for (auto& path : watcher.wait()) {
+            for (auto& spec : specs) {
+                fs::path relative;
+                if (MatchInput(spec, path, relative) && fs::is_regular_file(path)) {
+                    changed.push_back(InputFile{ path, relative });
+                    break;
+                }
+            }
+        }
+        if (changed.empty()) continue;
+
+        pool.parallelFor(changed.size(), [&](size_t i) { convertFile(changed[i]); });
+        saveAfterBatch();
+        std::cout.flush();
+    }
+}
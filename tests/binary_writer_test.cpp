@@ -0,0 +1,205 @@
+#include "test.h"
+#include "binary_writer.h"
+#include <functional>
+#include <initializer_list>
+
+// ============================ BinaryWriter ============================
+
+namespace {
+
+std::string Bytes(std::initializer_list<int> bytes) {
+    std::string text;
+    for (int byte : bytes) text += static_cast<char>(byte);
+    return text;
+}
+
+std::string Encode(BinaryFormat format, const std::function<void(BinaryWriter&)>& write, size_t flushSize = 64 * 1024) {
+    std::string out;
+    BinaryWriter writer(format, [&out](std::string_view chunk) { out.append(chunk); }, flushSize);
+    write(writer);
+    writer.flush();
+    return out;
+}
+
+std::string Number(BinaryFormat format, double value) {
+    return Encode(format, [value](BinaryWriter& writer) { writer.number(value); });
+}
+
+// ַֻȡͷݲȽ
+std::string StringHead(BinaryFormat format, size_t length, size_t headSize) {
+    std::string text(length, 'x');
+    return Encode(format, [&text](BinaryWriter& writer) { writer.string(text); }).substr(0, headSize);
+}
+
+const BinaryFormat kMsgpack = BinaryFormat::MessagePack;
+const BinaryFormat kCbor = BinaryFormat::Cbor;
+
+} // namespace
+
+TEST(MessagePackNumbersUseShortestEncoding) {
+    CHECK_EQ(Number(kMsgpack, 0), Bytes({ 0x00 }));
+    CHECK_EQ(Number(kMsgpack, 127), Bytes({ 0x7F }));
+    CHECK_EQ(Number(kMsgpack, 128), Bytes({ 0xCC, 0x80 }));
+    CHECK_EQ(Number(kMsgpack, 256), Bytes({ 0xCD, 0x01, 0x00 }));
+    CHECK_EQ(Number(kMsgpack, 65536), Bytes({ 0xCE, 0x00, 0x01, 0x00, 0x00 }));
+    CHECK_EQ(Number(kMsgpack, 4294967296.0), Bytes({ 0xCF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK_EQ(Number(kMsgpack, -1), Bytes({ 0xFF }));
+    CHECK_EQ(Number(kMsgpack, -32), Bytes({ 0xE0 }));
+    CHECK_EQ(Number(kMsgpack, -33), Bytes({ 0xD0, 0xDF }));
+    CHECK_EQ(Number(kMsgpack, -129), Bytes({ 0xD1, 0xFF, 0x7F }));
+    CHECK_EQ(Number(kMsgpack, -32769), Bytes({ 0xD2, 0xFF, 0xFF, 0x7F, 0xFF }));
+
+    // -0.0Լ2^53ֵдfloat64
+    CHECK_EQ(Number(kMsgpack, 0.5), Bytes({ 0xCB, 0x3F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK_EQ(Number(kMsgpack, -0.0), Bytes({ 0xCB, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK_EQ(Number(kMsgpack, 9007199254740992.0), Bytes({ 0xCB, 0x43, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+}
+
+TEST(CborNumbersUseShortestEncoding) {
+    CHECK_EQ(Number(kCbor, 0), Bytes({ 0x00 }));
+    CHECK_EQ(Number(kCbor, 23), Bytes({ 0x17 }));
+    CHECK_EQ(Number(kCbor, 24), Bytes({ 0x18, 0x18 }));
+    CHECK_EQ(Number(kCbor, 256), Bytes({ 0x19, 0x01, 0x00 }));
+    CHECK_EQ(Number(kCbor, 65536), Bytes({ 0x1A, 0x00, 0x01, 0x00, 0x00 }));
+    CHECK_EQ(Number(kCbor, 4294967296.0), Bytes({ 0x1B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK_EQ(Number(kCbor, -1), Bytes({ 0x20 }));
+    CHECK_EQ(Number(kCbor, -24), Bytes({ 0x37 }));
+    CHECK_EQ(Number(kCbor, -25), Bytes({ 0x38, 0x18 }));
+    CHECK_EQ(Number(kCbor, -257), Bytes({ 0x39, 0x01, 0x00 }));
+    CHECK_EQ(Number(kCbor, 0.5), Bytes({ 0xFB, 0x3F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK_EQ(Number(kCbor, -0.0), Bytes({ 0xFB, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+}
+
+TEST(BinaryWriterNullAndBooleans) {
+    auto literals = [](BinaryWriter& writer) {
+        writer.null();
+        writer.boolean(true);
+        writer.boolean(false);
+    };
+    CHECK_EQ(Encode(kMsgpack, literals), Bytes({ 0xC0, 0xC3, 0xC2 }));
+    CHECK_EQ(Encode(kCbor, literals), Bytes({ 0xF6, 0xF5, 0xF4 }));
+}
+
+TEST(BinaryWriterStringLengthHeaders) {
+    CHECK_EQ(Encode(kMsgpack, [](BinaryWriter& writer) { writer.string("ab"); }), Bytes({ 0xA2, 'a', 'b' }));
+    CHECK_EQ(StringHead(kMsgpack, 31, 1), Bytes({ 0xBF }));
+    CHECK_EQ(StringHead(kMsgpack, 32, 2), Bytes({ 0xD9, 0x20 }));
+    CHECK_EQ(StringHead(kMsgpack, 256, 3), Bytes({ 0xDA, 0x01, 0x00 }));
+    CHECK_EQ(StringHead(kMsgpack, 65536, 5), Bytes({ 0xDB, 0x00, 0x01, 0x00, 0x00 }));
+
+    CHECK_EQ(Encode(kCbor, [](BinaryWriter& writer) { writer.string("ab"); }), Bytes({ 0x62, 'a', 'b' }));
+    CHECK_EQ(StringHead(kCbor, 23, 1), Bytes({ 0x77 }));
+    CHECK_EQ(StringHead(kCbor, 24, 2), Bytes({ 0x78, 0x18 }));
+    CHECK_EQ(StringHead(kCbor, 256, 3), Bytes({ 0x79, 0x01, 0x00 }));
+}
+
+TEST(BinaryWriterContainerHeaders) {
+    auto headers = [](size_t count) {
+        return [count](BinaryWriter& writer) {
+            writer.beginArray(count);
+            writer.beginMap(count);
+        };
+    };
+    CHECK_EQ(Encode(kMsgpack, headers(15)), Bytes({ 0x9F, 0x8F }));
+    CHECK_EQ(Encode(kMsgpack, headers(16)), Bytes({ 0xDC, 0x00, 0x10, 0xDE, 0x00, 0x10 }));
+    CHECK_EQ(Encode(kMsgpack, headers(65536)), Bytes({ 0xDD, 0x00, 0x01, 0x00, 0x00, 0xDF, 0x00, 0x01, 0x00, 0x00 }));
+    CHECK_EQ(Encode(kCbor, headers(3)), Bytes({ 0x83, 0xA3 }));
+    CHECK_EQ(Encode(kCbor, headers(24)), Bytes({ 0x98, 0x18, 0xB8, 0x18 }));
+}
+
+TEST(BinaryWriterPlaceholdersAreFiveBytes) {
+    uint64_t position = 0;
+    std::string cbor = Encode(kCbor, [&position](BinaryWriter& writer) {
+        writer.beginDocument();
+        position = writer.beginArrayPlaceholder();
+        writer.null();
+    });
+    CHECK_EQ(position, uint64_t(3));
+    CHECK_EQ(cbor, Bytes({ 0xD9, 0x01, 0x00, 0x9A, 0x00, 0x00, 0x00, 0x00, 0xF6 }));
+
+    std::string msgpack = Encode(kMsgpack, [&position](BinaryWriter& writer) {
+        writer.beginDocument();
+        position = writer.beginMapPlaceholder();
+    });
+    CHECK_EQ(position, uint64_t(0));
+    CHECK_EQ(msgpack, Bytes({ 0xDF, 0x00, 0x00, 0x00, 0x00 }));
+
+    BinaryWriter msgpackWriter(kMsgpack, [](std::string_view) {});
+    BinaryWriter cborWriter(kCbor, [](std::string_view) {});
+    CHECK_EQ(msgpackWriter.countHeader(false, 300), Bytes({ 0xDD, 0x00, 0x00, 0x01, 0x2C }));
+    CHECK_EQ(msgpackWriter.countHeader(true, 2), Bytes({ 0xDF, 0x00, 0x00, 0x00, 0x02 }));
+    CHECK_EQ(cborWriter.countHeader(false, 2), Bytes({ 0x9A, 0x00, 0x00, 0x00, 0x02 }));
+    CHECK_EQ(cborWriter.countHeader(true, 300), Bytes({ 0xBA, 0x00, 0x00, 0x01, 0x2C }));
+}
+
+TEST(BinaryWriterOffsetCountsFlushedBytes) {
+    // Сÿֵ֮󶼽
+    uint64_t position = 0;
+    std::string out = Encode(kMsgpack, [&position](BinaryWriter& writer) {
+        writer.number(65536);
+        writer.number(65536);
+        position = writer.beginArrayPlaceholder();
+    }, 4);
+    CHECK_EQ(position, uint64_t(10));
+    CHECK_EQ(out.size(), size_t(15));
+}
+
+TEST(MessagePackStringRefsOnlyWhenShorter) {
+    std::string out = Encode(kMsgpack, [](BinaryWriter& writer) {
+        uint32_t abc = BinaryWriter::kNoRef;
+        uint32_t ab = BinaryWriter::kNoRef;
+        uint32_t later = BinaryWriter::kNoRef;
+        writer.string("abc", abc);      // 0
+        writer.string("ab", ab);        // 1
+        writer.string("abc", abc);      // 3ֽڣı4ֽ
+        writer.string("ab", ab);        // ı3ֽڲóдһıռ2
+        writer.string("zz");            // ȥصַͬţ3
+        writer.string("later", later);  // 4
+        writer.string("later", later);
+    });
+    CHECK_EQ(out, Bytes({
+        0xA3, 'a', 'b', 'c',
+        0xA2, 'a', 'b',
+        0xD4, BinaryWriter::kStringRefExt, 0x00,
+        0xA2, 'a', 'b',
+        0xA2, 'z', 'z',
+        0xA5, 'l', 'a', 't', 'e', 'r',
+        0xD4, BinaryWriter::kStringRefExt, 0x04 }));
+}
+
+TEST(CborStringRefsFollowTheStandard) {
+    uint32_t shortRef = BinaryWriter::kNoRef;
+    uint32_t longRef = BinaryWriter::kNoRef;
+    std::string out = Encode(kCbor, [&](BinaryWriter& writer) {
+        writer.beginDocument();
+        writer.string("ab", shortRef);      // 3ֽڣñ
+        writer.string("ab", shortRef);
+        writer.string("abc", longRef);      // 0
+        writer.string("abc", longRef);
+    });
+    CHECK_EQ(shortRef, BinaryWriter::kNoRef);
+    CHECK_EQ(longRef, uint32_t(0));
+    CHECK_EQ(out, Bytes({
+        0xD9, 0x01, 0x00,
+        0x62, 'a', 'b',
+        0x62, 'a', 'b',
+        0x63, 'a', 'b', 'c',
+        0xD8, 0x19, 0x00 }));
+
+    // ñ24ñ䳤3ֽڵַٽñ4ֽڵĲŽ
+    uint32_t three = BinaryWriter::kNoRef;
+    uint32_t four = BinaryWriter::kNoRef;
+    std::string tail = Encode(kCbor, [&](BinaryWriter& writer) {
+        writer.beginDocument();
+        for (int i = 0; i < 24; ++i) {
+            char text[] = { 'k', static_cast<char>('a' + i / 10), static_cast<char>('a' + i % 10), 0 };
+            writer.string(text);
+        }
+        writer.string("xyz", three);
+        writer.string("wxyz", four);
+        writer.string("wxyz", four);
+    });
+    CHECK_EQ(three, BinaryWriter::kNoRef);
+    CHECK_EQ(four, uint32_t(24));
+    CHECK_EQ(tail.substr(tail.size() - 4), Bytes({ 0xD8, 0x19, 0x18, 0x18 }));
+}
@@ -0,0 +1,104 @@
+#include "test.h"
+#include "conversion_cache.h"
+#include "hash64.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+// ============================ ݹϣ嵥 ============================
+
+namespace {
+
+std::filesystem::path CacheDir() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "xlsx2json-test-cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+void WriteFile(const std::filesystem::path& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+}
+
+uint64_t HashOf(const std::string& text, uint64_t seed = 0) {
+    Hash64 hash(seed);
+    hash.update(text.data(), text.size());
+    return hash.digest();
+}
+
+} // namespace
+
+TEST(Hash64MatchesReferenceXxh64) {
+    CHECK_EQ(HashOf(""), 0xEF46DB3751D8E999ull);
+    CHECK_EQ(HashOf("abc"), 0x44BC2CF5AD770999ull);
+    CHECK_EQ(HashOf("abc", 1), 0xBEA9CA8199328908ull);
+    CHECK_EQ(HashOf("The quick brown fox jumps over the lazy dog"), 0x0B242D361FDA71BCull);
+
+    // ֿһθ½ͬ
+    std::string bytes;
+    for (int i = 0; i < 1024; ++i) bytes += static_cast<char>(i & 0xFF);
+    CHECK_EQ(HashOf(bytes), 0x6F3914F18FE4DF57ull);
+    Hash64 pieces;
+    for (size_t i = 0; i < bytes.size(); i += 7) pieces.update(bytes.data() + i, std::min<size_t>(7, bytes.size() - i));
+    CHECK_EQ(pieces.digest(), 0x6F3914F18FE4DF57ull);
+
+    CHECK_EQ(HashFromHex(HashToHex(0x0123456789ABCDEFull)), 0x0123456789ABCDEFull);
+}
+
+TEST(ManifestSkipsOnlyUnchangedOutputs) {
+    std::filesystem::path dir = CacheDir();
+    std::filesystem::path source = dir / "book.xlsx";
+    std::filesystem::path output = dir / "book.json";
+    WriteFile(source, "source");
+    WriteFile(output, "[1,2,3]");
+
+    {
+        ConversionManifest manifest(dir / "manifest");
+        auto state = ConversionManifest::sourceState(source);
+        CHECK(!manifest.isUpToDate(source, "v", state));
+        manifest.update(source, "v", state, { ConvertOutput{ output, 7, Hash64::ofFile(output), 1, false } });
+        manifest.save();
+    }
+
+    ConversionManifest manifest(dir / "manifest");
+    auto state = ConversionManifest::sourceState(source);
+    CHECK(manifest.isUpToDate(source, "v", state));
+    CHECK(!manifest.isUpToDate(source, "other options", state));
+    CHECK(manifest.canReuseOutput(source, "v", output, 1));
+    CHECK(!manifest.canReuseOutput(source, "v", output, 2));
+
+    // ݲֻʱԿСͬݸĹת
+    std::filesystem::last_write_time(output, std::filesystem::last_write_time(output) + std::chrono::seconds(5));
+    CHECK(manifest.isUpToDate(source, "v", state));
+    WriteFile(output, "[1,2,4]");
+    std::filesystem::last_write_time(output, std::filesystem::last_write_time(output) + std::chrono::seconds(10));
+    CHECK(!manifest.isUpToDate(source, "v", state));
+    CHECK(!manifest.canReuseOutput(source, "v", output, 1));
+
+    std::filesystem::remove(output);
+    CHECK(!manifest.isUpToDate(source, "v", state));
+}
+
+TEST(ManifestSkipsRealConversionOutputs) {
+    // µĴСժҪǴϵֽڣзʽͬƽ̨Ҳһ
+    std::filesystem::path dir = CacheDir();
+    std::filesystem::path source = dir / "fixture.xlsx";
+    std::filesystem::copy_file(TestDataPath("fixture.xlsx"), source);
+    ConvertOptions options;
+    options.allSheets = true;
+    ConvertResult result = Xlsx2Json(source, dir / "fixture.json", options);
+    CHECK_EQ(result.outputs.size(), size_t(4));
+    for (auto& output : result.outputs) {
+        CHECK_EQ(output.bytes, uint64_t(std::filesystem::file_size(output.path)));
+        CHECK_EQ(output.hash, Hash64::ofFile(output.path));
+    }
+
+    ConversionManifest manifest(dir / "manifest");
+    auto state = ConversionManifest::sourceState(source);
+    manifest.update(source, ConvertOptionsKey(options), state, result.outputs);
+    CHECK(manifest.isUpToDate(source, ConvertOptionsKey(options), state));
+    for (auto& output : result.outputs) {
+        CHECK(manifest.canReuseOutput(source, ConvertOptionsKey(options), output.path, output.fingerprint));
+    }
+}
@@ -0,0 +1,200 @@
+#include "test.h"
+#include "converter.h"
+#include "thread_pool.h"
+#include <fstream>
+#include <iterator>
+
+// ============================ ת ============================
+
+/**
+ * fixture.xlsxֽڱȽJSONΪGBK룬"\xC6\xBB\xB9\xFB""ƻ"
+ * ֻòָʽȾѡxlntİ汾޹
+ */
+namespace {
+
+const char kApple[] = "\xC6\xBB\xB9\xFB";
+
+std::filesystem::path OutputDir() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "xlsx2json-test";
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// WindowsJSONCRLFУJSONıĻзת壬ֱӻ'\n'Ƚ
+std::string ReadJson(const std::filesystem::path& path) {
+    std::string lf;
+    for (char ch : ReadFile(path)) {
+        if (ch != '\r') lf += ch;
+    }
+    return lf;
+}
+
+// תһļ
+std::string ConvertSheet(const std::string& sheet, ConvertOptions options) {
+    options.allSheets = true;
+    options.sheets = { sheet };
+    std::filesystem::path desPath = OutputDir() / ("fixture" + OutputExtension(options).string());
+    ConvertResult result = Xlsx2Json(TestDataPath("fixture.xlsx"), desPath, options);
+    if (result.failedSheets > 0 || result.outputs.size() != 1) return "<failed>";
+    return options.format == OutputFormat::Json ? ReadJson(result.outputs[0].path) : ReadFile(result.outputs[0].path);
+}
+
+ConvertOptions Typed(JsonLayout layout = JsonLayout::Compact) {
+    ConvertOptions options;
+    options.typedValues = true;
+    options.layout = layout;
+    return options;
+}
+
+} // namespace
+
+TEST(ConvertDefaultMatchesJsoncppOutput) {
+    CHECK_EQ(ConvertSheet("Text", ConvertOptions()),
+        std::string("[\n"
+        "\t{\n"
+        "\t\t\"a\" : \"") + kApple + "\",\n"
+        "\t\t\"b\" : \"TRUE\"\n"
+        "\t},\n"
+        "\t{\n"
+        "\t\t\"a\" : \"\",\n"
+        "\t\t\"b\" : \"Banana\"\n"
+        "\t}\n"
+        "]\n");
+}
+
+TEST(ConvertSheetWithoutDataRowsWritesNull) {
+    CHECK_EQ(ConvertSheet("Header", ConvertOptions()), "null\n");
+    CHECK_EQ(ConvertSheet("Empty", ConvertOptions()), "null\n");
+    CHECK_EQ(ConvertSheet("Header", Typed()), "null\n");
+}
+
+TEST(ConvertTypedValues) {
+    CHECK_EQ(ConvertSheet("Items", Typed()),
+        std::string("[{\"id\":1,\"name\":\"") + kApple + "\",\"price\":3.5,\"ok\":true,\"note\":\"a\\\"b\\\\c\"},"
+        "{\"id\":2,\"name\":\"Banana\",\"price\":0.01,\"ok\":false,\"note\":null},"
+        "{\"id\":null,\"name\":null,\"price\":null,\"ok\":null,\"note\":null},"
+        "{\"id\":-4,\"name\":\"" + kApple + "\",\"price\":null,\"ok\":null,\"note\":\"tab\\there & <x>\"},"
+        "{\"id\":5,\"name\":\"inline\",\"price\":1e+20,\"ok\":null,\"note\":\"line1\\nline2\"}]\n");
+}
+
+TEST(ConvertRawValuesAndOmitEmpty) {
+    ConvertOptions raw;
+    raw.rawValues = true;
+    raw.layout = JsonLayout::Compact;
+    std::string text = ConvertSheet("Items", raw);
+    CHECK(text.find("\"price\":\"1.0000000000000001E-2\",\"ok\":\"FALSE\"") != std::string::npos);
+
+    ConvertOptions omit = Typed();
+    omit.omitEmpty = true;
+    CHECK_EQ(ConvertSheet("Text", omit), std::string("[{\"a\":\"") + kApple + "\",\"b\":true},{\"b\":\"Banana\"}]\n");
+}
+
+TEST(ConvertShapesAndLayouts) {
+    ConvertOptions rows = Typed();
+    rows.shape = TableShape::Rows;
+    CHECK_EQ(ConvertSheet("Text", rows),
+        std::string("{\"columns\":[\"a\",\"b\"],\"rows\":[[\"") + kApple + "\",true],[null,\"Banana\"]]}\n");
+
+    ConvertOptions columns;
+    columns.layout = JsonLayout::Compact;
+    columns.shape = TableShape::Columns;
+    CHECK_EQ(ConvertSheet("Text", columns),
+        std::string("{\"columns\":[\"a\",\"b\"],\"data\":{\"a\":[\"") + kApple + "\",\"\"],\"b\":[\"TRUE\",\"Banana\"]}}\n");
+
+    CHECK_EQ(ConvertSheet("Text", Typed(JsonLayout::Lines)),
+        std::string("{\"a\":\"") + kApple + "\",\"b\":true}\n{\"a\":null,\"b\":\"Banana\"}\n");
+
+    ConvertOptions rowLines = Typed(JsonLayout::Lines);
+    rowLines.shape = TableShape::Rows;
+    CHECK_EQ(ConvertSheet("Text", rowLines),
+        std::string("[\"a\",\"b\"]\n[\"") + kApple + "\",true]\n[null,\"Banana\"]\n");
+}
+
+TEST(ConvertKeyedObjects) {
+    ConvertOptions keyed = Typed();
+    keyed.keyColumn = "b";
+    CHECK_EQ(ConvertSheet("Text", keyed),
+        std::string("{\"true\":{\"a\":\"") + kApple + "\",\"b\":true},\"Banana\":{\"a\":null,\"b\":\"Banana\"}}\n");
+
+    // ȱʹűʧܣ
+    keyed.keyColumn = "price";
+    CHECK_EQ(ConvertSheet("Items", keyed), "<failed>");
+    keyed.keyColumn = "missing";
+    CHECK_EQ(ConvertSheet("Text", keyed), "<failed>");
+}
+
+TEST(ConvertRejectsUnsupportedCombinations) {
+    ConvertOptions options;
+    options.shape = TableShape::Columns;
+    options.layout = JsonLayout::Lines;
+    CHECK_THROWS(Xlsx2Json(TestDataPath("fixture.xlsx"), OutputDir() / "bad.json", options));
+
+    options = ConvertOptions();
+    options.format = OutputFormat::Cbor;
+    options.layout = JsonLayout::Lines;
+    CHECK_THROWS(Xlsx2Json(TestDataPath("fixture.xlsx"), OutputDir() / "bad.cbor", options));
+}
+
+/**
+ * quirks.xlsxһ<sheet>ĹϵڣȡʱactiveTabΪ2"a_b"
+ * "a/b""a_b""A:B"滻ַͬRowsкΪ132
+ */
+TEST(ConvertDisambiguatesCollidingSheetPaths) {
+    ConvertOptions options = Typed();
+    options.allSheets = true;
+    options.sheets = { "a/b", "a_b", "A:B" };
+    ThreadPool pool(3);
+    ConvertResult result = Xlsx2Json(TestDataPath("quirks.xlsx"), OutputDir() / "quirks.json", options, ConvertCallbacks(), &pool);
+    CHECK_EQ(result.failedSheets, size_t(0));
+    CHECK_EQ(result.outputs.size(), size_t(3));
+    CHECK_EQ(ReadJson(OutputDir() / "quirks_a_b.json"), "[{\"k\":1}]\n");
+    CHECK_EQ(ReadJson(OutputDir() / "quirks_a_b_2.json"), "[{\"k\":2}]\n");
+    CHECK_EQ(ReadJson(OutputDir() / "quirks_A_B_3.json"), "[{\"k\":3}]\n");
+}
+
+TEST(ConvertFailsSheetWithNonIncreasingRows) {
+    ConvertOptions options;
+    options.allSheets = true;
+    options.sheets = { "a_b", "Rows" };
+    std::vector<std::string> failed;
+    ConvertCallbacks callbacks;
+    callbacks.onSheetError = [&](const std::string& sheet, const std::string&) { failed.push_back(sheet); };
+    ConvertResult result = Xlsx2Json(TestDataPath("quirks.xlsx"), OutputDir() / "quirks.json", options, callbacks);
+    CHECK_EQ(result.failedSheets, size_t(1));
+    CHECK_EQ(result.outputs.size(), size_t(1));
+    CHECK(failed.size() == 1 && failed[0] == "Rows");
+    CHECK(!std::filesystem::exists(OutputDir() / "quirks_Rows.json"));
+}
+
+TEST(ConvertOptionsKeyChangesWithOutput) {
+    ConvertOptions options;
+    std::string plain = ConvertOptionsKey(options);
+    options.format = OutputFormat::MessagePack;
+    CHECK(ConvertOptionsKey(options) != plain);
+    CHECK_EQ(OutputExtension(options).string(), ".msgpack");
+    options.format = OutputFormat::Json;
+    options.layout = JsonLayout::Lines;
+    CHECK_EQ(OutputExtension(options).string(), ".ndjson");
+}
+
+TEST(ConvertBinaryFormats) {
+    // ƸʽַΪUTF-8"\xE8\x8B\xB9\xE6\x9E\x9C""ƻ"ֻ1ֽڣòı̣ȥ
+    ConvertOptions msgpack = Typed();
+    msgpack.format = OutputFormat::MessagePack;
+    CHECK_EQ(ConvertSheet("Text", msgpack), std::string(
+        "\xDD\x00\x00\x00\x02"
+        "\x82\xA1" "a" "\xA6\xE8\x8B\xB9\xE6\x9E\x9C" "\xA1" "b" "\xC3"
+        "\x82\xA1" "a" "\xC0" "\xA1" "b" "\xA6" "Banana", 31));
+
+    ConvertOptions cbor = Typed();
+    cbor.format = OutputFormat::Cbor;
+    CHECK_EQ(ConvertSheet("Text", cbor), std::string(
+        "\xD9\x01\x00" "\x9A\x00\x00\x00\x02"
+        "\xA2\x61" "a" "\x66\xE8\x8B\xB9\xE6\x9E\x9C" "\x61" "b" "\xF5"
+        "\xA2\x61" "a" "\xF6" "\x61" "b" "\x66" "Banana", 34));
+}
@@ -0,0 +1,43 @@
+#include "test.h"
+#include "gbk_encoder.h"
+
+// ============================ GBK ת ============================
+
+TEST(GbkEncoderMapsCommonCharacters) {
+    //  ƻ ȫǶţ
+    CHECK_EQ(Utf8ToGbk("\xE4\xB8\xAD\xE6\x96\x87"), "\xD6\xD0\xCE\xC4");
+    CHECK_EQ(Utf8ToGbk("\xE8\x8B\xB9\xE6\x9E\x9C"), "\xC6\xBB\xB9\xFB");
+    CHECK_EQ(Utf8ToGbk("\xEF\xBC\x8C"), "\xA3\xAC");
+}
+
+TEST(GbkEncoderCopiesAsciiRuns) {
+    // 16ֽڣοβ
+    std::string ascii = "{\"key\" : \"value\", \"n\" : 12345}\n\t";
+    CHECK_EQ(Utf8ToGbk(ascii), ascii);
+    CHECK_EQ(Utf8ToGbk(ascii + "\xE4\xB8\xAD" + ascii), ascii + "\xD6\xD0" + ascii);
+    CHECK_EQ(Utf8ToGbk(""), "");
+}
+
+TEST(GbkEncoderReplacesUnmappableCharacters) {
+    // U+1F600GBKУֽضϵжַ
+    CHECK_EQ(Utf8ToGbk("a\xF0\x9F\x98\x80" "b"), "a?b");
+    CHECK_EQ(Utf8ToGbk("\xE4\xB8"), "?");
+}
+
+TEST(GbkEncoderKeepsCharactersSplitAcrossChunks) {
+    GbkEncoder encoder;
+    std::string out;
+    encoder.encode("x\xE4", out);
+    encoder.encode("\xB8", out);
+    encoder.encode("\xAD\xE6\x96", out);
+    encoder.encode("\x87y", out);
+    encoder.finish(out);
+    CHECK_EQ(out, "x\xD6\xD0\xCE\xC4y");
+
+    // ʱĲַΪ'?'
+    GbkEncoder truncated;
+    std::string tail;
+    truncated.encode("z\xE6\x96", tail);
+    truncated.finish(tail);
+    CHECK_EQ(tail, "z?");
+}
@@ -0,0 +1,157 @@
+#include "test.h"
+#include "json_writer.h"
+
+// ============================ JsonWriter ============================
+
+namespace {
+
+/**
+ * дռһַchunks¼ÿνεĿ
+ */
+struct Collector {
+    std::string text;
+    std::vector<std::string> chunks;
+
+    JsonWriter::Sink sink() {
+        return [this](std::string_view chunk) {
+            text.append(chunk);
+            chunks.emplace_back(chunk);
+        };
+    }
+};
+
+JsonWriterSettings Layout(const char* indentation) {
+    JsonWriterSettings settings;
+    settings.indentation = indentation;
+    return settings;
+}
+
+// ԭJson::ValueĽṹͬ飬ֵǱ
+void WriteRows(JsonWriter& json) {
+    json.beginArray();
+    json.beginObject();
+    json.key("id");
+    json.literal("1");
+    json.key("name");
+    json.value("a");
+    json.endObject();
+    json.beginObject();
+    json.endObject();
+    json.endArray();
+    json.flush();
+}
+
+void WriteNested(JsonWriter& json) {
+    json.beginObject();
+    json.key("columns");
+    json.beginArray();
+    json.value("a");
+    json.literal("null");
+    json.endArray();
+    json.key("rows");
+    json.beginArray();
+    json.endArray();
+    json.endObject();
+    json.flush();
+}
+
+} // namespace
+
+TEST(JsonWriterMatchesJsoncppStyledLayout) {
+    Collector out;
+    JsonWriter json(Layout("\t"), out.sink());
+    WriteRows(json);
+    CHECK_EQ(out.text,
+        "[\n"
+        "\t{\n"
+        "\t\t\"id\" : 1,\n"
+        "\t\t\"name\" : \"a\"\n"
+        "\t},\n"
+        "\t{}\n"
+        "]");
+}
+
+TEST(JsonWriterKeepsNestedContainersOnTheKeyLine) {
+    // jsoncppڼУ̵ıдһУͳһӼڵпʼ
+    Collector out;
+    JsonWriter json(Layout("\t"), out.sink());
+    WriteNested(json);
+    CHECK_EQ(out.text,
+        "{\n"
+        "\t\"columns\" : [\n"
+        "\t\t\"a\",\n"
+        "\t\tnull\n"
+        "\t],\n"
+        "\t\"rows\" : []\n"
+        "}");
+}
+
+TEST(JsonWriterCompactLayoutHasNoWhitespace) {
+    Collector rows;
+    JsonWriter json(Layout(""), rows.sink());
+    WriteRows(json);
+    CHECK_EQ(rows.text, "[{\"id\":1,\"name\":\"a\"},{}]");
+
+    Collector nested;
+    JsonWriter compact(Layout(""), nested.sink());
+    WriteNested(compact);
+    CHECK_EQ(nested.text, "{\"columns\":[\"a\",null],\"rows\":[]}");
+}
+
+TEST(JsonWriterEscapesLikeJsoncpp) {
+    Collector out;
+    JsonWriter json(Layout(""), out.sink());
+    json.value(std::string_view("q\"b\\s/\b\f\n\r\t\x01\x1f\x7f", 14));
+    json.flush();
+    CHECK_EQ(out.text, "\"q\\\"b\\\\s/\\b\\f\\n\\r\\t\\u0001\\u001f\x7f\"");
+}
+
+TEST(JsonWriterEscapesNonAsciiWithoutEmitUtf8) {
+    JsonWriterSettings settings = Layout("");
+    Collector out;
+    JsonWriter utf8(settings, out.sink());
+    utf8.value("\xE8\x8B\xB9\xF0\x9F\x98\x80");
+    utf8.flush();
+    CHECK_EQ(out.text, "\"\xE8\x8B\xB9\xF0\x9F\x98\x80\"");
+
+    settings.emitUTF8 = false;
+    Collector escaped;
+    JsonWriter ascii(settings, escaped.sink());
+    ascii.value("\xE8\x8B\xB9\xF0\x9F\x98\x80\xFF");
+    ascii.flush();
+    CHECK_EQ(escaped.text, "\"\\u82f9\\ud83d\\ude00\\ufffd\"");
+}
+
+TEST(JsonWriterFlushesOnlyAtTokenBoundaries) {
+    Collector out;
+    JsonWriter json(Layout(""), out.sink(), 8);
+    json.beginArray();
+    for (int i = 0; i < 20; ++i) json.value("\xE8\x8B\xB9\xE6\x9E\x9C");
+    json.endArray();
+    json.flush();
+    CHECK(out.chunks.size() > 1);
+    for (auto& chunk : out.chunks) {
+        // ÿ鶼ļǺŽβпַUTF-8ַ
+        CHECK(chunk.back() == '"' || chunk.back() == ']');
+    }
+    CHECK_EQ(out.text.size(), 2u + 20 * 8 + 19);
+}
+
+TEST(JsonQuotedCacheQuotesOncePerIndex) {
+    Collector out;
+    JsonWriter json(Layout(""), out.sink());
+    JsonQuotedCache cache(json, 3);
+    CHECK_EQ(cache.get(1, "a\"b"), "\"a\\\"b\"");
+    CHECK_EQ(cache.get(0, ""), "\"\"");
+    // ѻıŲٿı
+    CHECK_EQ(cache.get(1, "ignored"), "\"a\\\"b\"");
+
+    json.beginObject();
+    std::pmr::string key;
+    json.quote("k", key);
+    json.quotedKey(key);
+    json.quotedValue(cache.get(1, "a\"b"));
+    json.endObject();
+    json.flush();
+    CHECK_EQ(out.text, "{\"k\":\"a\\\"b\"}");
+}
@@ -0,0 +1,48 @@
+#include "test.h"
+#include "key_index.h"
+#include <memory_resource>
+#include <string>
+
+// ============================ KeyIndex ============================
+
+TEST(KeyIndexReportsFirstRowOfDuplicates) {
+    KeyIndex index;
+    CHECK_EQ(index.insert("a", 2), uint32_t(0));
+    CHECK_EQ(index.insert("b", 3), uint32_t(0));
+    CHECK_EQ(index.insert("a", 4), uint32_t(2));
+    CHECK_EQ(index.insert("a", 5), uint32_t(2));
+    CHECK_EQ(index.size(), size_t(2));
+
+    // ַҲһͨļǰ׺ͬļӰ
+    CHECK_EQ(index.insert("", 6), uint32_t(0));
+    CHECK_EQ(index.insert("", 7), uint32_t(6));
+    CHECK_EQ(index.insert("ab", 8), uint32_t(0));
+    CHECK_EQ(index.size(), size_t(4));
+}
+
+TEST(KeyIndexSurvivesRehash) {
+    // Ԥ64λη
+    KeyIndex index;
+    const uint32_t count = 10000;
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK_EQ(index.insert("key" + std::to_string(i), i + 2), uint32_t(0));
+    }
+    CHECK_EQ(index.size(), size_t(count));
+
+    bool found = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (index.insert("key" + std::to_string(i), 1) != i + 2) found = false;
+    }
+    CHECK(found);
+    CHECK_EQ(index.size(), size_t(count));
+}
+
+TEST(KeyIndexWorksWithReserveAndArena) {
+    std::pmr::monotonic_buffer_resource arena;
+    KeyIndex index(&arena);
+    index.reserve(1000);
+    for (uint32_t i = 0; i < 1000; ++i) index.insert(std::to_string(i), i + 2);
+    CHECK_EQ(index.insert("999", 5000), uint32_t(1001));
+    CHECK_EQ(index.insert("1000", 5000), uint32_t(0));
+    CHECK_EQ(index.size(), size_t(1001));
+}
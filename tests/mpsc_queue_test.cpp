@@ -0,0 +1,67 @@
+#include "test.h"
+#include "log_channel.h"
+#include "mpsc_queue.h"
+#include <thread>
+#include <vector>
+
+// ============================ MpscQueue ============================
+
+TEST(MpscQueuePopOnEmptyReturnsFalse) {
+    MpscQueue<int> queue;
+    int value = -1;
+    CHECK(!queue.pop(value));
+    queue.push(7);
+    CHECK(queue.pop(value));
+    CHECK_EQ(value, 7);
+    CHECK(!queue.pop(value));
+}
+
+TEST(MpscQueueKeepsEachProducersOrder) {
+    // ԪرΪ  * kCount + ţ߱ȡ
+    const int kProducers = 4;
+    const int kCount = 20000;
+    MpscQueue<int> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kCount; ++i) queue.push(p * kCount + i);
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    bool ordered = true;
+    for (int received = 0; received < kProducers * kCount;) {
+        int value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / kCount;
+        if (value % kCount != next[producer]) ordered = false;
+        ++next[producer];
+        ++received;
+    }
+    for (std::thread& producer : producers) producer.join();
+
+    int value;
+    CHECK(!queue.pop(value));
+    CHECK(ordered);
+    for (int p = 0; p < kProducers; ++p) CHECK_EQ(next[p], kCount);
+}
+
+// ============================ LogTimeFormatter ============================
+
+TEST(LogTimeFormatterUsesFixedLayout) {
+    LogTimeFormatter formatter;
+    auto now = std::chrono::steady_clock::now();
+    std::string first = formatter.format(now);
+    CHECK_EQ(first.size(), size_t(23));
+    CHECK_EQ(first[4], '-');
+    CHECK_EQ(first[10], ' ');
+    CHECK_EQ(first[19], '.');
+
+    // ǰ׺Ȳ
+    std::string later = formatter.format(now + std::chrono::milliseconds(1500));
+    CHECK_EQ(later.size(), size_t(23));
+    CHECK(later != first);
+}
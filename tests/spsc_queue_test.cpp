@@ -0,0 +1,63 @@
+#include "test.h"
+#include "spsc_queue.h"
+#include <chrono>
+#include <string>
+#include <thread>
+
+// ============================ SpscQueue ============================
+
+TEST(SpscQueueKeepsOrderAcrossThreads) {
+    // ԶСԪظ߶Ҫȴ
+    SpscQueue<int> queue(3);
+    const int count = 100000;
+    std::thread producer([&]() {
+        for (int i = 0; i < count; ++i) {
+            int value = i;
+            if (!queue.push(std::move(value))) return;
+        }
+        queue.close();
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    for (int value; queue.pop(value); ++expected) {
+        if (value != expected) ordered = false;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK_EQ(expected, count);
+}
+
+TEST(SpscQueueCloseDrainsThenStops) {
+    SpscQueue<std::string> queue(4);
+    std::string a = "a";
+    std::string b = "b";
+    CHECK(queue.push(std::move(a)));
+    CHECK(queue.push(std::move(b)));
+    queue.close();
+
+    // رպٷ룬ѷԿȡ
+    std::string c = "c";
+    CHECK(!queue.push(std::move(c)));
+    std::string value;
+    CHECK(queue.pop(value));
+    CHECK_EQ(value, "a");
+    CHECK(queue.pop(value));
+    CHECK_EQ(value, "b");
+    CHECK(!queue.pop(value));
+}
+
+TEST(SpscQueueCloseWakesBlockedProducer) {
+    SpscQueue<int> queue(1);
+    int first = 1;
+    queue.push(std::move(first));
+    bool pushed = true;
+    std::thread producer([&]() {
+        int second = 2;
+        pushed = queue.push(std::move(second));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    producer.join();
+    CHECK(!pushed);
+}
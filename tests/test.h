@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// ============================ Ԫ ============================
+
+/**
+ * ԿܣTEST岢עCHECKʧʱλúִУCHECK_EQͬʱӡߵֵ
+ * ַֽڴӡɼַASCIIֽд\xHHڱȽ϶
+ */
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& TestRegistry();
+void TestFailure(const char* file, int line, const std::string& message);
+
+// Ŀ¼µļĿ¼ĬΪtests/dataеڶָ
+std::filesystem::path TestDataPath(const std::string& name);
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*run)()) { TestRegistry().push_back(TestCase{ name, run }); }
+};
+
+std::string TestPrintable(std::string_view text);
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T>, std::string> TestPrintable(T value) {
+    std::ostringstream oss;
+    oss << +value;
+    return oss.str();
+}
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) TestFailure(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const auto& actual_ = (actual); \
+        const auto& expected_ = (expected); \
+        if (!(actual_ == expected_)) { \
+            TestFailure(__FILE__, __LINE__, std::string(#actual " == " #expected "\n    actual:   ") + \
+                TestPrintable(actual_) + "\n    expected: " + TestPrintable(expected_)); \
+        } \
+    } while (0)
+
+#define CHECK_THROWS(expression) \
+    do { \
+        bool thrown_ = false; \
+        try { \
+            expression; \
+        } catch (const std::exception&) { \
+            thrown_ = true; \
+        } \
+        if (!thrown_) TestFailure(__FILE__, __LINE__, "no exception from " #expression); \
+    } while (0)
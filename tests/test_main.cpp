@@ -0,0 +1,67 @@
+#include "test.h"
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+namespace {
+
+int failures = 0;
+std::filesystem::path dataDir = "tests/data";
+
+} // namespace
+
+std::vector<TestCase>& TestRegistry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+void TestFailure(const char* file, int line, const std::string& message) {
+    ++failures;
+    std::cerr << file << ":" << line << ": " << message << std::endl;
+}
+
+std::filesystem::path TestDataPath(const std::string& name) {
+    return dataDir / name;
+}
+
+std::string TestPrintable(std::string_view text) {
+    std::string out = "\"";
+    for (unsigned char ch : text) {
+        if (ch >= 0x20 && ch < 0x7F && ch != '"' && ch != '\\') {
+            out += static_cast<char>(ch);
+        } else {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\x%02X", ch);
+            out += escaped;
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * ÷xlsx2json-test [һ] [Ŀ¼]
+ * ĿĿ¼Уxmake run ãʧʱ1
+ */
+int main(int argc, char* argv[]) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    if (argc > 2) dataDir = argv[2];
+
+    size_t run = 0;
+    size_t failed = 0;
+    for (auto& test : TestRegistry()) {
+        if (*filter && !std::strstr(test.name, filter)) continue;
+        int before = failures;
+        try {
+            test.run();
+        } catch (const std::exception& e) {
+            TestFailure(test.name, 0, std::string("exception: ") + e.what());
+        }
+        ++run;
+        if (failures != before) {
+            ++failed;
+            std::cerr << "FAILED " << test.name << std::endl;
+        }
+    }
+    std::cout << run - failed << " passed, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include "test.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <stdexcept>
+
+// ============================ ThreadPool ============================
+
+TEST(ThreadPoolRunsEveryIndexOnce) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](size_t i) { ++hits[i]; });
+    bool once = true;
+    for (auto& hit : hits) {
+        if (hit != 1) once = false;
+    }
+    CHECK(once);
+}
+
+TEST(ThreadPoolRethrowsFirstError) {
+    ThreadPool pool(2);
+    std::atomic<int> ran(0);
+    CHECK_THROWS(pool.parallelFor(10, [&](size_t i) {
+        ++ran;
+        if (i == 3) throw std::runtime_error("task failed");
+    }));
+    // Ӱ±ִ
+    CHECK_EQ(ran.load(), 10);
+}
+
+TEST(ThreadPoolNestedCallsRunOnlyTheirOwnBatch) {
+    // ȴڲʱȡ񣬷һ̵߳ջϻͬʱѹŶ
+    ThreadPool pool(2);
+    std::atomic<int> inner(0);
+    std::atomic<bool> nested(false);
+    pool.parallelFor(16, [&](size_t) {
+        thread_local int depth = 0;
+        if (depth > 0) nested = true;
+        ++depth;
+        pool.parallelFor(8, [&](size_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++inner;
+        });
+        --depth;
+    });
+    CHECK_EQ(inner.load(), 16 * 8);
+    CHECK(!nested);
+}
+
+TEST(ThreadPoolTryStartNeedsEnoughIdleWorkers) {
+    ThreadPool pool(2);
+    std::atomic<int> ran(0);
+    auto task = [&]() { ++ran; };
+    CHECK(!pool.tryStart({ task, task, task }));
+
+    // ȴֻͬʱõ̲߳ܽ
+    std::atomic<int> arrived(0);
+    auto meet = [&]() {
+        ++arrived;
+        while (arrived < 2) std::this_thread::yield();
+        ++ran;
+    };
+    CHECK(pool.tryStart({ meet, meet }));
+    while (ran < 2) std::this_thread::yield();
+    CHECK_EQ(ran.load(), 2);
+}
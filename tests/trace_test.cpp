@@ -0,0 +1,27 @@
+#include "test.h"
+#include "trace.h"
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+// ============================ ʱ߸ ============================
+
+TEST(TraceReusesBuffersOfExitedThreads) {
+    // еĶ̹߳һ߳
+    Trace::start();
+    for (int i = 0; i < 20; ++i) {
+        std::thread([]() { TraceScope scope("task", "test"); }).join();
+    }
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "xlsx2json-test-trace.json";
+    Trace::writeJson(path);
+
+    std::ifstream file(path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto count = [&](std::string_view pattern) {
+        size_t n = 0;
+        for (size_t pos = 0; (pos = text.find(pattern, pos)) != std::string::npos; pos += pattern.size()) ++n;
+        return n;
+    };
+    CHECK_EQ(count("\"name\":\"thread_name\""), size_t(1));
+    CHECK_EQ(count("\"name\":\"task\""), size_t(20));
+}
@@ -0,0 +1,228 @@
+#include "test.h"
+#include "xlsx_reader.h"
+#include "zip_archive.h"
+#include <fstream>
+#include <iterator>
+
+// ============================ Zip / XML / ȡ ============================
+
+/**
+ * fixture.xlsxĸûstyles.xml
+ * Items   ͷid,name,price,ok,note4ûд洢ֵַַ"1.0000000000000001E-2"ԭ
+ * Text    ַֻ벼ֵ
+ * Header  ֻбͷ
+ * Empty   û<dimension>Ҳû
+ */
+namespace {
+
+std::string ReadAll(ZipEntryStream& stream) {
+    std::string text;
+    char buffer[7];     // Сǿȡ
+    for (size_t n; (n = stream.read(buffer, sizeof(buffer))) > 0;) text.append(buffer, n);
+    return text;
+}
+
+/**
+ * fixture.xlsxĿ¼ĳĿCRC32ĵݲ
+ */
+std::filesystem::path CopyWithBadCrc(const std::string& entryName) {
+    std::ifstream in(TestDataPath("fixture.xlsx"), std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    for (size_t pos = 0; (pos = bytes.find(entryName, pos)) != std::string::npos; pos += entryName.size()) {
+        // Ŀ¼¼ǩPK\1\2CRC32ƫ16ļƫ46
+        if (pos >= 46 && bytes.compare(pos - 46, 4, "PK\x01\x02") == 0) bytes[pos - 46 + 16] ^= 0x5A;
+    }
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "xlsx2json-test-badcrc.xlsx";
+    std::ofstream out(path, std::ios::binary);
+    out << bytes;
+    return path;
+}
+
+} // namespace
+
+TEST(ZipArchiveListsAndInflatesEntries) {
+    ZipArchive zip(TestDataPath("fixture.xlsx"));
+    CHECK(zip.find("xl/workbook.xml") != nullptr);
+    CHECK(zip.find("xl/missing.xml") == nullptr);
+
+    const ZipEntry* sheet = zip.find("xl/worksheets/sheet3.xml");
+    CHECK(sheet != nullptr);
+    if (!sheet) return;
+    CHECK_EQ(sheet->method, 8);
+    auto stream = zip.open(*sheet);
+    std::string text = ReadAll(*stream);
+    CHECK_EQ(text.size(), sheet->uncompressedSize);
+    CHECK(text.find("<dimension ref=\"A1:B1\"/>") != std::string::npos);
+}
+
+TEST(ZipArchiveRejectsNonZipFiles) {
+    CHECK_THROWS(ZipArchive(TestDataPath("missing.xlsx")));
+}
+
+TEST(ZipEntryStreamChecksCrc) {
+    std::filesystem::path path = CopyWithBadCrc("xl/worksheets/sheet2.xml");
+    ZipArchive zip(path);
+    auto intact = zip.open("xl/worksheets/sheet1.xml");
+    ReadAll(*intact);
+    auto corrupt = zip.open("xl/worksheets/sheet2.xml");
+    CHECK_THROWS(ReadAll(*corrupt));
+
+    // ĩβǰݵı
+    XlsxWorkbook wb(path);
+    auto readSheet = [&](size_t index) {
+        XlsxSheetReader reader(wb, index);
+        XlsxRow row;
+        while (reader.nextRow(row)) {}
+    };
+    readSheet(0);
+    CHECK_THROWS(readSheet(1));
+}
+
+TEST(XmlReaderDecodesEntitiesAndStripsPrefixes) {
+    ZipArchive zip(TestDataPath("fixture.xlsx"));
+    XmlReader xml(zip.open("xl/sharedStrings.xml"));
+    std::vector<std::string> texts;
+    bool inText = false;
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event == XmlReader::Event::StartElement && xml.name() == "t") {
+            inText = true;
+            texts.emplace_back();
+            const std::string* space = xml.attribute("space");
+            CHECK(space && *space == "preserve");
+        } else if (event == XmlReader::Event::EndElement && xml.name() == "t") {
+            inText = false;
+        } else if (event == XmlReader::Event::Text && inText) {
+            texts.back() += xml.text();
+        }
+    }
+    CHECK_EQ(texts.size(), 12u);
+    if (texts.size() < 10) return;
+    CHECK_EQ(texts[7], "a\"b\\c");
+    CHECK_EQ(texts[8], "tab\there & <x>");
+    CHECK_EQ(texts[9], "line1\nline2");
+}
+
+TEST(WorkbookReadsSheetsAndSharedStrings) {
+    XlsxWorkbook wb(TestDataPath("fixture.xlsx"));
+    CHECK_EQ(wb.sheets().size(), 4u);
+    CHECK_EQ(wb.activeSheet(), 0u);
+    if (wb.sheets().size() == 4) {
+        CHECK_EQ(wb.sheets()[0].name, "Items");
+        CHECK_EQ(wb.sheets()[3].name, "Empty");
+        CHECK_EQ(wb.sheets()[1].path, "xl/worksheets/sheet2.xml");
+    }
+    CHECK_EQ(wb.sharedStrings().size(), 12u);
+    CHECK_EQ(wb.sharedStrings()[5], "\xE8\x8B\xB9\xE6\x9E\x9C");
+    CHECK_EQ(wb.sharedStrings()[11], "b");
+
+    // ָֻȡĿ¼ͬһļδͬͬͬ
+    XlsxWorkbook again(TestDataPath("fixture.xlsx"), false);
+    CHECK_EQ(again.sheetFingerprint(0), wb.sheetFingerprint(0));
+    CHECK(wb.sheetFingerprint(0) != wb.sheetFingerprint(1));
+}
+
+TEST(WorkbookResolvesActiveTabBeforeSkippingSheets) {
+    // quirks.xlsxһ<sheet>ĹϵڱactiveTab="2"ָδǰĵ<sheet>"a_b"
+    XlsxWorkbook wb(TestDataPath("quirks.xlsx"));
+    CHECK_EQ(wb.sheets().size(), 4u);
+    CHECK_EQ(wb.sheets()[wb.activeSheet()].name, "a_b");
+}
+
+TEST(SheetReaderStreamsStoredRows) {
+    XlsxWorkbook wb(TestDataPath("fixture.xlsx"));
+    XlsxSheetReader reader(wb, 0);
+    CHECK_EQ(reader.dimension().lastRow, 6u);
+    CHECK_EQ(reader.dimension().lastColumn, 5u);
+
+    std::vector<uint32_t> indices;
+    XlsxRow row;
+    XlsxRow fifth;
+    while (reader.nextRow(row)) {
+        indices.push_back(row.index);
+        if (row.index == 5) fifth = row;
+    }
+    CHECK(indices == std::vector<uint32_t>({ 1, 2, 3, 5, 6 }));
+
+    // 5УA֡BַEַCDûд洢
+    CHECK_EQ(fifth.count, 3u);
+    if (fifth.count == 3) {
+        CHECK_EQ(fifth.cells[0].column, 1u);
+        CHECK(fifth.cells[0].type == XlsxCellType::Number);
+        CHECK_EQ(fifth.cells[0].value, "-4");
+        CHECK(fifth.cells[1].type == XlsxCellType::SharedString);
+        CHECK_EQ(fifth.cells[1].value, "5");
+        CHECK_EQ(fifth.cells[2].column, 5u);
+    }
+
+    XlsxSheetReader empty(wb, 3);
+    CHECK_EQ(empty.dimension().lastRow, 0u);
+    CHECK(!empty.nextRow(row));
+}
+
+TEST(SheetReaderRejectsNonIncreasingRows) {
+    // quirks.xlsxRowsкΪ132
+    XlsxWorkbook wb(TestDataPath("quirks.xlsx"));
+    XlsxSheetReader reader(wb, 3);
+    XlsxRow row;
+    CHECK(reader.nextRow(row));
+    CHECK(reader.nextRow(row));
+    CHECK_EQ(row.index, 3u);
+    CHECK_THROWS(reader.nextRow(row));
+}
+
+TEST(RowExtractorFillsTypedDenseBuffer) {
+    XlsxWorkbook wb(TestDataPath("fixture.xlsx"));
+    XlsxSheetReader reader(wb, 0);
+    XlsxRowExtractor extractor(wb, reader.dimension().lastColumn);
+    XlsxRow row;
+
+    reader.nextRow(row);
+    extractor.extract(&row);
+    XlsxHeader header;
+    header.build(extractor);
+    CHECK(header.keys == std::vector<std::string>({ "id", "name", "price", "ok", "note" }));
+
+    reader.nextRow(row);
+    extractor.extract(&row, true);
+    CHECK(extractor.kind(0) == XlsxValueKind::Number);
+    CHECK_EQ(extractor.number(2), 3.5);
+    CHECK(extractor.kind(3) == XlsxValueKind::Boolean);
+    CHECK_EQ(extractor.value(3), "true");
+    CHECK_EQ(extractor.sharedIndex(1), 5u);
+
+    // ʾһдб
+    reader.nextRow(row);
+    extractor.extract(&row, true);
+    CHECK_EQ(extractor.value(2), "0.01");
+    CHECK_EQ(extractor.value(3), "false");
+    CHECK(!extractor.hasValue(4));
+    CHECK(extractor.sharedIndex(4) == XlsxRowExtractor::kNotShared);
+
+    // ʱֵֶַ
+    extractor.extract(&row, false);
+    CHECK(extractor.kind(3) == XlsxValueKind::String);
+    CHECK_EQ(extractor.value(3), "FALSE");
+
+    extractor.extract(nullptr);
+    CHECK(extractor.empty());
+    CHECK(!extractor.hasValue(0));
+}
+
+TEST(RowExtractorRawValuesKeepStoredText) {
+    XlsxWorkbook wb(TestDataPath("fixture.xlsx"), false);
+    wb.loadSharedParts(false);
+    XlsxSheetReader reader(wb, 0);
+    XlsxRowExtractor extractor(wb, reader.dimension().lastColumn, true);
+    XlsxRow row;
+    for (int i = 0; i < 3; ++i) reader.nextRow(row);
+    extractor.extract(&row);
+    CHECK_EQ(extractor.value(2), "1.0000000000000001E-2");
+    CHECK_EQ(extractor.value(3), "FALSE");
+}
+
+TEST(ColumnIndexFromReferenceParsesLetters) {
+    CHECK_EQ(ColumnIndexFromReference("A"), 1u);
+    CHECK_EQ(ColumnIndexFromReference("Z9"), 26u);
+    CHECK_EQ(ColumnIndexFromReference("AA1"), 27u);
+    CHECK_EQ(ColumnIndexFromReference("$XFD$1"), 16384u);
+}
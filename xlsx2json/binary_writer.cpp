@@ -0,0 +1,260 @@
+#include "binary_writer.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// ֵС2^53ֵdoubleתΪ
+const double kMaxExactInteger = 9007199254740992.0;
+
+void PutBigEndian(std::pmr::string& out, uint64_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        out += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+void PutByte(std::pmr::string& out, uint8_t value) {
+    out += static_cast<char>(value);
+}
+
+} // namespace
+
+BinaryWriter::BinaryWriter(BinaryFormat format, Sink sink, size_t flushSize, std::pmr::memory_resource* memory)
+    : format(format), sink(std::move(sink)), flushSize(flushSize), buffer(memory), flushed(0), nextRef(0) {
+    buffer.reserve(flushSize + 4096);
+}
+
+void BinaryWriter::afterToken() {
+    if (buffer.size() >= flushSize) flush();
+}
+
+void BinaryWriter::flush() {
+    if (buffer.empty()) return;
+    sink(buffer);
+    flushed += buffer.size();
+    buffer.clear();
+}
+
+/**
+ * CBORͷ3λΪֵͣС24ʱֱӷڵ5λ5λΪ24~271/2/4/8ֽ
+ */
+void BinaryWriter::writeHead(uint8_t major, uint64_t value) {
+    uint8_t type = static_cast<uint8_t>(major << 5);
+    if (value < 24) {
+        PutByte(buffer, static_cast<uint8_t>(type | value));
+    } else if (value <= 0xFF) {
+        PutByte(buffer, type | 24);
+        PutBigEndian(buffer, value, 1);
+    } else if (value <= 0xFFFF) {
+        PutByte(buffer, type | 25);
+        PutBigEndian(buffer, value, 2);
+    } else if (value <= 0xFFFFFFFF) {
+        PutByte(buffer, type | 26);
+        PutBigEndian(buffer, value, 4);
+    } else {
+        PutByte(buffer, type | 27);
+        PutBigEndian(buffer, value, 8);
+    }
+}
+
+void BinaryWriter::beginDocument() {
+    if (format == BinaryFormat::Cbor) writeHead(6, 256);
+}
+
+void BinaryWriter::beginArray(size_t count) {
+    if (format == BinaryFormat::Cbor) {
+        writeHead(4, count);
+    } else if (count < 16) {
+        PutByte(buffer, static_cast<uint8_t>(0x90 | count));
+    } else if (count <= 0xFFFF) {
+        PutByte(buffer, 0xDC);
+        PutBigEndian(buffer, count, 2);
+    } else {
+        PutByte(buffer, 0xDD);
+        PutBigEndian(buffer, count, 4);
+    }
+}
+
+void BinaryWriter::beginMap(size_t count) {
+    if (format == BinaryFormat::Cbor) {
+        writeHead(5, count);
+    } else if (count < 16) {
+        PutByte(buffer, static_cast<uint8_t>(0x80 | count));
+    } else if (count <= 0xFFFF) {
+        PutByte(buffer, 0xDE);
+        PutBigEndian(buffer, count, 2);
+    } else {
+        PutByte(buffer, 0xDF);
+        PutBigEndian(buffer, count, 4);
+    }
+}
+
+uint64_t BinaryWriter::beginPlaceholder(bool isMap) {
+    uint64_t position = offset();
+    buffer += countHeader(isMap, 0);
+    return position;
+}
+
+uint64_t BinaryWriter::beginArrayPlaceholder() {
+    return beginPlaceholder(false);
+}
+
+uint64_t BinaryWriter::beginMapPlaceholder() {
+    return beginPlaceholder(true);
+}
+
+/**
+ * ̶5ֽڣMessagePackarray32/map32CBORϢΪ264ֽڳȣ/ӳ
+ */
+std::string BinaryWriter::countHeader(bool isMap, uint32_t count) const {
+    std::pmr::string header;
+    if (format == BinaryFormat::Cbor) {
+        PutByte(header, isMap ? 0xBA : 0x9A);
+    } else {
+        PutByte(header, isMap ? 0xDF : 0xDD);
+    }
+    PutBigEndian(header, count, 4);
+    return std::string(header);
+}
+
+void BinaryWriter::null() {
+    PutByte(buffer, format == BinaryFormat::Cbor ? 0xF6 : 0xC0);
+    afterToken();
+}
+
+void BinaryWriter::boolean(bool value) {
+    if (format == BinaryFormat::Cbor) PutByte(buffer, value ? 0xF5 : 0xF4);
+    else PutByte(buffer, value ? 0xC3 : 0xC2);
+    afterToken();
+}
+
+void BinaryWriter::number(double value) {
+    // -0.0д
+    bool integral = std::trunc(value) == value && std::fabs(value) < kMaxExactInteger && !(value == 0 && std::signbit(value));
+    if (!integral) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        PutByte(buffer, format == BinaryFormat::Cbor ? 0xFB : 0xCB);
+        PutBigEndian(buffer, bits, 8);
+        afterToken();
+        return;
+    }
+
+    int64_t integer = static_cast<int64_t>(value);
+    if (format == BinaryFormat::Cbor) {
+        if (integer >= 0) writeHead(0, static_cast<uint64_t>(integer));
+        else writeHead(1, static_cast<uint64_t>(-1 - integer));
+    } else if (integer >= 0) {
+        if (integer < 128) {
+            PutByte(buffer, static_cast<uint8_t>(integer));
+        } else if (integer <= 0xFF) {
+            PutByte(buffer, 0xCC);
+            PutBigEndian(buffer, integer, 1);
+        } else if (integer <= 0xFFFF) {
+            PutByte(buffer, 0xCD);
+            PutBigEndian(buffer, integer, 2);
+        } else if (integer <= 0xFFFFFFFF) {
+            PutByte(buffer, 0xCE);
+            PutBigEndian(buffer, integer, 4);
+        } else {
+            PutByte(buffer, 0xCF);
+            PutBigEndian(buffer, integer, 8);
+        }
+    } else {
+        uint64_t bits = static_cast<uint64_t>(integer);
+        if (integer >= -32) {
+            PutByte(buffer, static_cast<uint8_t>(integer));
+        } else if (integer >= INT8_MIN) {
+            PutByte(buffer, 0xD0);
+            PutBigEndian(buffer, bits, 1);
+        } else if (integer >= INT16_MIN) {
+            PutByte(buffer, 0xD1);
+            PutBigEndian(buffer, bits, 2);
+        } else if (integer >= INT32_MIN) {
+            PutByte(buffer, 0xD2);
+            PutBigEndian(buffer, bits, 4);
+        } else {
+            PutByte(buffer, 0xD3);
+            PutBigEndian(buffer, bits, 8);
+        }
+    }
+    afterToken();
+}
+
+// ====== ַȥ ======
+
+/**
+ * ıдַǷñ
+ * MessagePackÿ룻CBORstringrefĹֻбֽڸʱŽ
+ */
+bool BinaryWriter::takesIndex(size_t length) const {
+    if (format == BinaryFormat::MessagePack) return true;
+    size_t minLength = nextRef < 24 ? 3 : nextRef < 256 ? 4 : nextRef < 65536 ? 5 : 7;
+    return length >= minLength;
+}
+
+size_t BinaryWriter::literalSize(size_t length) const {
+    return length + (length < 32 ? 1 : length < 256 ? 2 : length < 65536 ? 3 : 5);
+}
+
+size_t BinaryWriter::refSize(uint32_t ref) const {
+    return ref < 256 ? 3 : ref < 65536 ? 4 : 6;
+}
+
+void BinaryWriter::writeLiteral(std::string_view text) {
+    if (takesIndex(text.size())) ++nextRef;
+
+    size_t length = text.size();
+    if (format == BinaryFormat::Cbor) {
+        writeHead(3, length);
+    } else if (length < 32) {
+        PutByte(buffer, static_cast<uint8_t>(0xA0 | length));
+    } else if (length <= 0xFF) {
+        PutByte(buffer, 0xD9);
+        PutBigEndian(buffer, length, 1);
+    } else if (length <= 0xFFFF) {
+        PutByte(buffer, 0xDA);
+        PutBigEndian(buffer, length, 2);
+    } else {
+        PutByte(buffer, 0xDB);
+        PutBigEndian(buffer, length, 4);
+    }
+    buffer.append(text.data(), text.size());
+}
+
+void BinaryWriter::writeRef(uint32_t ref) {
+    if (format == BinaryFormat::Cbor) {
+        writeHead(6, 25);
+        writeHead(0, ref);
+    } else if (ref <= 0xFF) {
+        PutByte(buffer, 0xD4);
+        PutByte(buffer, kStringRefExt);
+        PutBigEndian(buffer, ref, 1);
+    } else if (ref <= 0xFFFF) {
+        PutByte(buffer, 0xD5);
+        PutByte(buffer, kStringRefExt);
+        PutBigEndian(buffer, ref, 2);
+    } else {
+        PutByte(buffer, 0xD6);
+        PutByte(buffer, kStringRefExt);
+        PutBigEndian(buffer, ref, 4);
+    }
+}
+
+void BinaryWriter::string(std::string_view text) {
+    writeLiteral(text);
+    afterToken();
+}
+
+void BinaryWriter::string(std::string_view text, uint32_t& ref) {
+    // CBORñַһı
+    if (ref != kNoRef && (format == BinaryFormat::Cbor || refSize(ref) < literalSize(text.size()))) {
+        writeRef(ref);
+    } else {
+        uint32_t index = nextRef;
+        bool indexed = takesIndex(text.size());
+        writeLiteral(text);
+        if (indexed && ref == kNoRef) ref = index;
+    }
+    afterToken();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+// ============================ ʽ ============================
+
+enum class BinaryFormat {
+    MessagePack,
+    Cbor
+};
+
+/**
+ * MessagePack / CBOR ʽJsonWriterһд߰ݽ
+ * ַΪUTF-8ͬǵõֽͬ
+ *
+ * ַȥأ
+ * CBORstringref׼tag 256סĵtag 25(n)õnַͨýֱչ
+ * MessagePackûб׼չkStringRefExtغΪ޷nõnıдַ
+ * ʱÿstrӳļαżɻԭ
+ */
+class BinaryWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    static constexpr uint32_t kNoRef = UINT32_MAX;
+    static constexpr int8_t kStringRefExt = 1;
+
+    BinaryWriter(BinaryFormat format, Sink sink, size_t flushSize = 64 * 1024,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // CBORĵͷдtag 256MessagePackʲôҲд
+    void beginDocument();
+
+    void beginArray(size_t count);
+    void beginMap(size_t count);
+
+    // ԪظҪд֪ӳ䣺д̶ȵĳȣеƫƣ
+    // дɵcountHeaderɵֽڸ
+    uint64_t beginArrayPlaceholder();
+    uint64_t beginMapPlaceholder();
+    std::string countHeader(bool isMap, uint32_t count) const;
+
+    void null();
+    void boolean(bool value);
+    // ̵ֵ룬Ϊfloat64
+    void number(double value);
+
+    // ȥصַ
+    void string(std::string_view text);
+    // refɵΪͬһַ棬ʼΪkNoRefдһ֮дʱñı̾д
+    void string(std::string_view text, uint32_t& ref);
+
+    // ĿǰΪֹֽڻ
+    uint64_t offset() const { return flushed + buffer.size(); }
+    void flush();
+
+private:
+    void writeHead(uint8_t major, uint64_t value);
+    void writeLiteral(std::string_view text);
+    void writeRef(uint32_t ref);
+    size_t literalSize(size_t length) const;
+    size_t refSize(uint32_t ref) const;
+    bool takesIndex(size_t length) const;
+    uint64_t beginPlaceholder(bool isMap);
+    void afterToken();
+
+    BinaryFormat format;
+    Sink sink;
+    size_t flushSize;
+    std::pmr::string buffer;
+    uint64_t flushed;
+    uint32_t nextRef;
+};
@@ -0,0 +1,248 @@
+#include "conversion_cache.h"
+#include "hash64.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kManifestHeader[] = "# xlsx2json manifest 3";
+
+std::vector<std::string> SplitTabs(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+// 嵥СƱֶָвַܳ
+std::string Sanitize(std::string text) {
+    for (auto& ch : text) {
+        if (ch == '\t' || ch == '\n' || ch == '\r') ch = ' ';
+    }
+    return text;
+}
+
+int64_t ModifiedTime(const fs::path& path) {
+    return static_cast<int64_t>(fs::last_write_time(path).time_since_epoch().count());
+}
+
+} // namespace
+
+ConversionManifest::ConversionManifest(const fs::path& path)
+    : manifestPath(path), baseDir(fs::absolute(path).parent_path().lexically_normal()), dirty(false) {
+    load();
+}
+
+void ConversionManifest::load() {
+    std::ifstream file(manifestPath, std::ios::binary);
+    if (!file) return;
+
+    std::string line;
+    if (!std::getline(file, line) || line != kManifestHeader) {
+        // 汾ʶ͵û嵥ȫת
+        return;
+    }
+
+    Entry* current = nullptr;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        auto fields = SplitTabs(line);
+        if (fields[0] == "S" && fields.size() == 6) {
+            Entry entry;
+            entry.size = std::strtoull(fields[2].c_str(), nullptr, 10);
+            entry.modified = std::strtoll(fields[3].c_str(), nullptr, 10);
+            entry.hash = HashFromHex(fields[4]);
+            entry.options = fields[5];
+            current = &(entries[fields[1]] = std::move(entry));
+        } else if (fields[0] == "O" && fields.size() == 6 && current) {
+            current->outputs.push_back(OutputRecord{ fields[1], std::strtoull(fields[2].c_str(), nullptr, 10),
+                std::strtoll(fields[3].c_str(), nullptr, 10), HashFromHex(fields[4]), HashFromHex(fields[5]) });
+        }
+    }
+}
+
+/**
+ * 嵥е·嵥Ŀ¼Ŀ¼ߺȻЧ
+ */
+std::string ConversionManifest::keyFor(const fs::path& path) const {
+    fs::path absolute = fs::absolute(path).lexically_normal();
+    fs::path relative = absolute.lexically_relative(baseDir);
+    std::u8string text = (relative.empty() ? absolute : relative).generic_u8string();
+    return Sanitize(std::string(text.begin(), text.end()));
+}
+
+fs::path ConversionManifest::resolve(const std::string& key) const {
+    fs::path path = PathFromUtf8(key);
+    return path.is_absolute() ? path : baseDir / path;
+}
+
+/**
+ * û䣺СֱͬжĹ޸ʱҲͬʱļȽݹϣ
+ * ϣֻͬʱʱʱoutputɵд
+ */
+bool ConversionManifest::outputUnchanged(OutputRecord& output) const {
+    fs::path path = resolve(output.path);
+    std::error_code ec;
+    if (fs::file_size(path, ec) != output.bytes || ec) return false;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) return false;
+    int64_t modified = static_cast<int64_t>(time.time_since_epoch().count());
+    if (modified == output.modified) return true;
+    if (Hash64::ofFile(path) != output.hash) return false;
+    output.modified = modified;
+    return true;
+}
+
+void ConversionManifest::refreshOutputTimes(const std::string& key, const std::vector<OutputRecord>& outputs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) return;
+    for (auto& output : outputs) {
+        for (auto& previous : it->second.outputs) {
+            if (previous.path == output.path && previous.hash == output.hash && previous.modified != output.modified) {
+                previous.modified = output.modified;
+                dirty = true;
+            }
+        }
+    }
+}
+
+ConversionManifest::SourceState ConversionManifest::sourceState(const fs::path& source) {
+    SourceState state;
+    state.size = fs::file_size(source);
+    state.modified = ModifiedTime(source);
+    return state;
+}
+
+bool ConversionManifest::isUpToDate(const fs::path& source, const std::string& optionsKey, SourceState& state) {
+    std::string key = keyFor(source);
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) return false;
+        entry = it->second;
+    }
+
+    if (entry.options != Sanitize(optionsKey) || entry.size != state.size) return false;
+
+    // ɾĶʱ
+    for (auto& output : entry.outputs) {
+        if (!outputUnchanged(output)) return false;
+    }
+    refreshOutputTimes(key, entry.outputs);
+
+    if (entry.modified == state.modified) return true;
+
+    // ʱ˵Сû䣨±桢Ƚݹϣ
+    state.hash = Hash64::ofFile(source);
+    state.hashed = true;
+    if (state.hash != entry.hash) return false;
+
+    // ûֻʱˣʱ䣬´βٶļ
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        it->second.modified = state.modified;
+        dirty = true;
+    }
+    return true;
+}
+
+bool ConversionManifest::canReuseOutput(const fs::path& source, const std::string& optionsKey,
+    const fs::path& output, uint64_t fingerprint) {
+    std::string key = keyFor(source);
+    std::string outputKey = keyFor(output);
+    OutputRecord record;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.options != Sanitize(optionsKey)) return false;
+        auto found = std::find_if(it->second.outputs.begin(), it->second.outputs.end(),
+            [&](const OutputRecord& previous) { return previous.path == outputKey; });
+        if (found == it->second.outputs.end() || found->fingerprint != fingerprint) return false;
+        record = *found;
+    }
+    if (!outputUnchanged(record)) return false;
+    refreshOutputTimes(key, { record });
+    return true;
+}
+
+void ConversionManifest::update(const fs::path& source, const std::string& optionsKey, SourceState state,
+    const std::vector<ConvertOutput>& outputs) {
+    if (!state.hashed) {
+        state.hash = Hash64::ofFile(source);
+    }
+
+    Entry entry;
+    entry.size = state.size;
+    entry.modified = state.modified;
+    entry.hash = state.hash;
+    entry.options = Sanitize(optionsKey);
+    for (auto& output : outputs) {
+        std::error_code ec;
+        auto time = fs::last_write_time(output.path, ec);
+        int64_t modified = ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+        entry.outputs.push_back(OutputRecord{ keyFor(output.path), output.bytes, modified, output.hash, output.fingerprint });
+    }
+
+    std::string key = keyFor(source);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (!outputs[i].reused || it == entries.end()) continue;
+        for (auto& previous : it->second.outputs) {
+            if (previous.path == entry.outputs[i].path) {
+                entry.outputs[i].bytes = previous.bytes;
+                entry.outputs[i].modified = previous.modified;
+                entry.outputs[i].hash = previous.hash;
+            }
+        }
+    }
+    entries[key] = std::move(entry);
+    dirty = true;
+}
+
+void ConversionManifest::remove(const fs::path& source) {
+    std::string key = keyFor(source);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.erase(key) > 0) dirty = true;
+}
+
+void ConversionManifest::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty) return;
+
+    std::ostringstream oss;
+    oss << kManifestHeader << '\n';
+    for (auto& [key, entry] : entries) {
+        oss << "S\t" << key << '\t' << entry.size << '\t' << entry.modified << '\t'
+            << HashToHex(entry.hash) << '\t' << entry.options << '\n';
+        for (auto& output : entry.outputs) {
+            oss << "O\t" << output.path << '\t' << output.bytes << '\t' << output.modified << '\t' << HashToHex(output.hash) << '\t'
+                << HashToHex(output.fingerprint) << '\n';
+        }
+    }
+
+    if (manifestPath.has_parent_path()) fs::create_directories(manifestPath.parent_path());
+    fs::path tmpPath = manifestPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        file << oss.str();
+        if (!file) {
+            throw std::runtime_error("cannot write " + PathToUtf8(tmpPath));
+        }
+    }
+    fs::rename(tmpPath, manifestPath);
+    dirty = false;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "converter.h"
+
+// ============================ ת ============================
+
+/**
+ * ת嵥Ŀ¼Ա
+ * ÿԴļ¼С޸ʱ䡢ݹϣתѡԼÿļĴС޸ʱ͹ϣ
+ * Դļѡû䡢ҲûĹʱתС޸ʱһʱļݶ
+ * ԴļʱָٰȽϣֻתĹĹ
+ * ڶ߳ͬʱ
+ */
+class ConversionManifest {
+public:
+    /**
+     * Դļǰ״̬hashֻҪʱż
+     */
+    struct SourceState {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0;
+        bool hashed = false;
+    };
+
+    explicit ConversionManifest(const std::filesystem::path& path);
+
+    const std::filesystem::path& path() const { return manifestPath; }
+
+    // ȡԴļĴС޸ʱ䣬תǰãתڼԴļĶʱ´Իת
+    static SourceState sourceState(const std::filesystem::path& source);
+
+    // жԴļǷҪȽʱĹϣstateupdate
+    bool isUpToDate(const std::filesystem::path& source, const std::string& optionsKey, SourceState& state);
+
+    // Դļ仯жĳϴεܷãѡָͬļûĹ
+    bool canReuseOutput(const std::filesystem::path& source, const std::string& optionsKey,
+        const std::filesystem::path& output, uint64_t fingerprint);
+
+    // ¼תreusedϴμ¼ĴСϣ
+    void update(const std::filesystem::path& source, const std::string& optionsKey, SourceState state,
+        const std::vector<ConvertOutput>& outputs);
+
+    // תʧʱɾ¼´һת
+    void remove(const std::filesystem::path& source);
+
+    // иĶʱд嵥ļдʱļ滻
+    void save();
+
+private:
+    struct OutputRecord {
+        std::string path;
+        uint64_t bytes = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0;
+        uint64_t fingerprint = 0;
+    };
+
+    struct Entry {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0;
+        std::string options;
+        std::vector<OutputRecord> outputs;
+    };
+
+    void load();
+    std::string keyFor(const std::filesystem::path& path) const;
+    std::filesystem::path resolve(const std::string& key) const;
+    bool outputUnchanged(OutputRecord& output) const;
+    void refreshOutputTimes(const std::string& key, const std::vector<OutputRecord>& outputs);
+
+    std::filesystem::path manifestPath;
+    std::filesystem::path baseDir;
+    std::map<std::string, Entry> entries;
+    std::mutex mutex;
+    bool dirty;
+};
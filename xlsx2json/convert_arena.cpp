@@ -0,0 +1,19 @@
+#include "convert_arena.h"
+
+namespace {
+
+// פĵһ黺壬Сȫɣ󰴼ϵͳ룬ͷʱ黹
+const size_t kInitialBlockSize = 256 * 1024;
+
+} // namespace
+
+ConvertArena::ConvertArena()
+    : initialBlock(new std::byte[kInitialBlockSize]),
+      pool(initialBlock.get(), kInitialBlockSize, std::pmr::new_delete_resource()),
+      depth(0) {
+}
+
+ConvertArena& ConvertArena::local() {
+    thread_local ConvertArena arena;
+    return arena;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+// ============================ תڴ ============================
+
+/**
+ * ÿ߳һĵڴأתһʱʱ嶼䣬ͷʱʲôҲ
+ * תһԹ黹һ黺һֱһת֮߳䲻malloc
+ * ̷ֻ߳䣬ܽ߳޸
+ */
+class ConvertArena {
+public:
+    static ConvertArena& local();
+
+    std::pmr::memory_resource* resource() { return &pool; }
+
+    ConvertArena(const ConvertArena&) = delete;
+    ConvertArena& operator=(const ConvertArena&) = delete;
+
+private:
+    friend class ConvertArenaScope;
+
+    ConvertArena();
+
+    std::unique_ptr<std::byte[]> initialBlock;
+    std::pmr::monotonic_buffer_resource pool;
+    int depth;
+};
+
+/**
+ * ʹñ߳ڴص򣬿Ƕףʱͷųеȫ
+ * ӳзǰ
+ */
+class ConvertArenaScope {
+public:
+    ConvertArenaScope() : arena(ConvertArena::local()) { ++arena.depth; }
+    ~ConvertArenaScope() {
+        if (--arena.depth == 0) arena.pool.release();
+    }
+
+    std::pmr::memory_resource* resource() { return arena.resource(); }
+
+    ConvertArenaScope(const ConvertArenaScope&) = delete;
+    ConvertArenaScope& operator=(const ConvertArenaScope&) = delete;
+
+private:
+    ConvertArena& arena;
+};
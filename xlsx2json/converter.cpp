@@ -0,0 +1,846 @@
+#include "converter.h"
+#include "xlsx_reader.h"
+#include "json_writer.h"
+#include "binary_writer.h"
+#include "gbk_encoder.h"
+#include "hash64.h"
+#include "thread_pool.h"
+#include "spsc_queue.h"
+#include "trace.h"
+#include "convert_arena.h"
+#include "key_index.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t kProgressInterval = 1024;
+
+// ʽ仯ʱʹɵʧЧ
+const int kConverterVersion = 3;
+
+// ˮ߲ÿڸ֮תkPipelineMinRowsıڵǰ߳˳
+const size_t kBatchRows = 256;
+const size_t kBatchCount = 8;
+const size_t kChunkCount = 8;
+const size_t kPipelineMinRows = 4096;
+
+// εС<dimension>ССֻһΣÿ鲻
+const size_t kEstimatedCellBytes = 16;
+const size_t kMinFlushSize = 64 * 1024;
+const size_t kMaxFlushSize = 1024 * 1024;
+
+// JSONWindowsCRLFУԭıʽļͬļԶƷʽ򿪣µĴСժҪϵֽ
+#ifdef _WIN32
+const bool kCrlfNewlines = true;
+#else
+const bool kCrlfNewlines = false;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * ڵĺʱۼӵһ׶
+ */
+class StageTimer {
+public:
+    explicit StageTimer(double& seconds) : seconds(seconds), start(Clock::now()) {}
+    ~StageTimer() { seconds += std::chrono::duration<double>(Clock::now() - start).count(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    double& seconds;
+    Clock::time_point start;
+};
+
+/**
+ * '\n'"\r\n"׷ӵoutGBK˫ַֽĵڶֽڲС0x40ᱻ
+ */
+void AppendCrlf(std::string_view text, std::string& out) {
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            out.append(text.data() + begin, text.size() - begin);
+            break;
+        }
+        out.append(text.data() + begin, end - begin);
+        out += "\r\n";
+        begin = end + 1;
+    }
+}
+
+uint64_t PartSize(const XlsxWorkbook& wb, const std::string& partPath) {
+    const ZipEntry* entry = wb.archive().find(partPath);
+    return entry ? entry->uncompressedSize : 0;
+}
+
+/**
+ * һõУڽл֮ѭ
+ */
+struct RowBatch {
+    std::vector<XlsxRow> rows;
+    size_t count = 0;
+};
+
+/**
+ * ˮߵһ̳߳صĿйִ߳У쳣ɵjoin׳
+ * ȴһʼstartAllڿ̲߳ʱһҲ߸Ϊ˳
+ */
+class StageTask {
+public:
+    StageTask(std::function<void()> fn, std::function<void()> onError)
+        : fn(std::move(fn)), onError(std::move(onError)), started(false), done(false) {
+    }
+
+    // ȥŵջϵĶУʱ
+    ~StageTask() {
+        wait();
+    }
+
+    StageTask(const StageTask&) = delete;
+    StageTask& operator=(const StageTask&) = delete;
+
+    static bool startAll(ThreadPool& pool, std::initializer_list<StageTask*> stages) {
+        std::vector<std::function<void()>> group;
+        for (StageTask* stage : stages) group.push_back([stage]() { stage->run(); });
+        if (!pool.tryStart(std::move(group))) return false;
+        for (StageTask* stage : stages) stage->started = true;
+        return true;
+    }
+
+    void join() {
+        wait();
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    void run() {
+        try {
+            fn();
+        } catch (...) {
+            error = std::current_exception();
+            onError();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        finished.notify_all();
+    }
+
+    void wait() {
+        if (!started) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return done; });
+    }
+
+    std::function<void()> fn;
+    std::function<void()> onError;
+    std::exception_ptr error;
+    bool started;
+    bool done;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+/**
+ * תʧʱɾдһʱļļ֮ǰ죬ʹļȹرɾ
+ */
+class TempFileGuard {
+public:
+    explicit TempFileGuard(const fs::path& path) : path(path), committed(false) {}
+    ~TempFileGuard() {
+        std::error_code ec;
+        if (!committed) fs::remove(path, ec);
+    }
+
+    void commit() { committed = true; }
+
+    TempFileGuard(const TempFileGuard&) = delete;
+    TempFileGuard& operator=(const TempFileGuard&) = delete;
+
+private:
+    fs::path path;
+    bool committed;
+};
+
+/**
+ * תڹ߳е
+ * ˮߣѹ -> ȡJSON -> GBKת벢дļд̳߳صĿй̣߳
+ * ֮ндκ飬ʱεȴڴռĴС޹أ
+ * ûpoolûп߳ʱڵǰ߳˳ͬʱæŵ̳߳߳صĴС
+ * лĻӵǰ̵߳ڴط䣬תһι黹̼߳תĬϷ
+ * Ƹʽת룬дصļռλλò
+ */
+void ConvertSheet(const XlsxWorkbook& wb, size_t sheetIndex, const fs::path& desPath, uint64_t fingerprint,
+    const ConvertOptions& options, const ConvertCallbacks& callbacks, ThreadPool* pool, ConvertResult& result) {
+    const std::string& sheetName = wb.sheets()[sheetIndex].name;
+    TraceScope traceSheet("sheet", "convert", sheetName);
+    ConvertArenaScope arena;
+    // ÿ׶ֻԼ߳ۼӸԵļϺٶȡ
+    ConvertStats& stats = result.stats;
+    stats.bytes[ConvertStats::Parse] += PartSize(wb, wb.sheets()[sheetIndex].path);
+    XlsxSheetReader reader(wb, sheetIndex);
+    auto& dim = reader.dimension();
+
+    size_t max_row = dim.lastRow;
+    size_t max_column = dim.lastColumn;
+
+    if (callbacks.onSheetBegin) callbacks.onSheetBegin(sheetName, max_column, max_row);
+
+    // дʱļɺ滻ʧʱ°ļ
+    fs::path tmpPath = desPath;
+    tmpPath += ".tmp";
+    TempFileGuard tmpGuard(tmpPath);
+    bool binary = options.format != OutputFormat::Json;
+    std::ofstream outPut(tmpPath, std::ios::out | std::ios::binary);
+
+    // ====== дתGBKдת뻺ڿ֮临ãƸʽԭд ======
+    GbkEncoder encoder;
+    std::string gbkChunk;
+    std::string crlfChunk;
+    uint64_t outputBytes = 0;
+    Hash64 outputHash;
+    auto writeChunk = [&](std::string_view chunk) {
+        TraceScope trace("write", "stage");
+        std::string_view bytes = chunk;
+        if (!binary) {
+            StageTimer timer(stats.seconds[ConvertStats::Transcode]);
+            encoder.encode(chunk, gbkChunk);
+            stats.bytes[ConvertStats::Transcode] += gbkChunk.size();
+            bytes = gbkChunk;
+            if (kCrlfNewlines) {
+                AppendCrlf(gbkChunk, crlfChunk);
+                bytes = crlfChunk;
+            }
+        }
+        StageTimer timer(stats.seconds[ConvertStats::Write]);
+        outPut.write(bytes.data(), bytes.size());
+        outputBytes += bytes.size();
+        stats.bytes[ConvertStats::Write] += bytes.size();
+        outputHash.update(bytes.data(), bytes.size());
+        gbkChunk.clear();
+        crlfChunk.clear();
+    };
+
+    // ====== нѹ룬һ ======
+    auto fillBatch = [&](RowBatch& batch) {
+        TraceScope trace("parse", "stage");
+        StageTimer timer(stats.seconds[ConvertStats::Parse]);
+        if (batch.rows.size() < kBatchRows) batch.rows.resize(kBatchRows);
+        batch.count = 0;
+        while (batch.count < kBatchRows && reader.nextRow(batch.rows[batch.count])) {
+            ++batch.count;
+        }
+        return batch.count > 0;
+    };
+
+    // ====== лһжȡȡJSON ======
+    bool pipelined = max_row >= kPipelineMinRows && pool;
+    SpscQueue<std::string> fullChunks(kChunkCount);
+    SpscQueue<std::string> freeChunks(kChunkCount);
+    std::string pendingChunk;
+
+    JsonWriterSettings settings;
+    settings.indentation = options.layout == JsonLayout::Pretty ? "\t" : "";
+    settings.emitUTF8 = true;
+    size_t flushSize = std::clamp(max_row * std::max<size_t>(max_column, 1) * kEstimatedCellBytes, kMinFlushSize, kMaxFlushSize);
+    auto emitChunk = [&](std::string_view chunk) {
+        stats.bytes[ConvertStats::Json] += chunk.size();
+        if (!pipelined) {
+            writeChunk(chunk);
+            return;
+        }
+        // תĿ̶ΪkChunkCountȫдʱһ飬дʱл֮ͣ£
+        // falseֻڶѹرգдʱpushҲʧ
+        if (!freeChunks.pop(pendingChunk)) pendingChunk.clear();
+        pendingChunk.assign(chunk.data(), chunk.size());
+        if (!fullChunks.push(std::move(pendingChunk))) {
+            throw std::runtime_error("write stage stopped");
+        }
+    };
+    // ƸʽʱJsonWriterֻתȡСֵ
+    JsonWriter json(settings, emitChunk, binary ? kMinFlushSize : flushSize, arena.resource());
+    std::optional<BinaryWriter> packer;
+    if (binary) {
+        packer.emplace(options.format == OutputFormat::Cbor ? BinaryFormat::Cbor : BinaryFormat::MessagePack,
+            emitChunk, flushSize, arena.resource());
+    }
+
+    XlsxHeader header;
+    std::pmr::vector<std::pmr::string> quotedKeys(arena.resource());
+    JsonQuotedCache sharedStrings(json, binary ? 0 : wb.sharedStrings().size(), arena.resource());
+    XlsxRowExtractor extractor(wb, max_column, options.rawValues, arena.resource());
+    size_t rows = 0;
+    bool lines = options.layout == JsonLayout::Lines;
+    bool keyed = !options.keyColumn.empty();
+    size_t keyColumn = 0;
+    KeyIndex keyIndex(arena.resource());
+    // ColumnsлȾõֵÿֵ'\0'βJSONıвδת'\0'д
+    // Щűڵڴزǰľɿ飬ֵӽ
+    std::pmr::vector<std::pmr::string> columnValues(std::pmr::new_delete_resource());
+    // Ƹʽַȥأַšֶθһ
+    std::pmr::vector<uint32_t> sharedRefs(arena.resource());
+    std::pmr::vector<uint32_t> keyRefs(arena.resource());
+    if (binary) sharedRefs.assign(wb.sharedStrings().size(), BinaryWriter::kNoRef);
+    // д֪Objects飨keyedʱΪӳ䣩Rows"rows"ռλβʱ
+    uint64_t countOffset = 0;
+
+    // һֵַӹַȡֳת壬ֵ֡nullԭд
+    auto writeValue = [&](size_t column) {
+        XlsxValueKind kind = extractor.kind(column);
+        if (extractor.sharedIndex(column) != XlsxRowExtractor::kNotShared) {
+            json.quotedValue(sharedStrings.get(extractor.sharedIndex(column), extractor.value(column)));
+        } else if (!options.typedValues || kind == XlsxValueKind::String) {
+            json.value(extractor.value(column));
+        } else if (kind == XlsxValueKind::Empty) {
+            json.literal("null");
+        } else {
+            json.literal(extractor.value(column));
+        }
+    };
+    auto appendValue = [&](size_t column, std::pmr::string& out) {
+        XlsxValueKind kind = extractor.kind(column);
+        if (extractor.sharedIndex(column) != XlsxRowExtractor::kNotShared) {
+            out += sharedStrings.get(extractor.sharedIndex(column), extractor.value(column));
+        } else if (!options.typedValues || kind == XlsxValueKind::String) {
+            json.quote(extractor.value(column), out);
+        } else if (kind == XlsxValueKind::Empty) {
+            out += "null";
+        } else {
+            out += extractor.value(column);
+        }
+        out += '\0';
+    };
+    auto packValue = [&](size_t column) {
+        uint32_t index = extractor.sharedIndex(column);
+        switch (extractor.kind(column)) {
+        case XlsxValueKind::Empty:
+            packer->null();
+            break;
+        case XlsxValueKind::Number:
+            packer->number(extractor.number(column));
+            break;
+        case XlsxValueKind::Boolean:
+            packer->boolean(extractor.value(column) == "true");
+            break;
+        default:
+            if (index != XlsxRowExtractor::kNotShared) packer->string(extractor.value(column), sharedRefs[index]);
+            else packer->string(extractor.value(column));
+            break;
+        }
+    };
+    // һУkeyedʱдObjectsΪӳ䣬omitEmptyʱֵֶΣRowsΪ
+    auto packRow = [&]() {
+        if (keyed) packer->string(extractor.value(keyColumn));
+        if (options.shape == TableShape::Rows) {
+            packer->beginArray(header.fields.size());
+            for (auto& field : header.fields) packValue(field.valueColumn);
+            return;
+        }
+        size_t count = header.fields.size();
+        if (options.omitEmpty) {
+            count = std::count_if(header.fields.begin(), header.fields.end(),
+                [&](const XlsxHeader::Field& field) { return extractor.hasValue(field.valueColumn); });
+        }
+        packer->beginMap(count);
+        for (size_t i = 0; i < header.fields.size(); ++i) {
+            size_t column = header.fields[i].valueColumn;
+            if (options.omitEmpty && !extractor.hasValue(column)) continue;
+            packer->string(header.key(header.fields[i]), keyRefs[i]);
+            packValue(column);
+        }
+    };
+
+    // ĵͷObjectsΪ飻RowsColumnsΪд
+    bool begun = false;
+    auto beginDocument = [&]() {
+        begun = true;
+        if (binary) {
+            keyRefs.assign(header.fields.size(), BinaryWriter::kNoRef);
+            packer->beginDocument();
+            if (options.shape == TableShape::Rows) {
+                packer->beginMap(2);
+                packer->string("columns");
+                packer->beginArray(header.fields.size());
+                for (size_t i = 0; i < header.fields.size(); ++i) packer->string(header.key(header.fields[i]), keyRefs[i]);
+                packer->string("rows");
+            }
+            countOffset = keyed ? packer->beginMapPlaceholder() : packer->beginArrayPlaceholder();
+            return;
+        }
+        if (options.shape == TableShape::Objects) {
+            // 鵽һвſʼûʱjsoncppĿJson::Valueһnull
+            if (keyed) json.beginObject();
+            return;
+        }
+        if (!lines) {
+            json.beginObject();
+            json.key("columns");
+        }
+        json.beginArray();
+        for (auto& quoted : quotedKeys) json.quotedValue(quoted);
+        json.endArray();
+        if (lines) {
+            json.raw("\n");
+        } else if (options.shape == TableShape::Rows) {
+            json.key("rows");
+            if (keyed) json.beginObject();
+            else json.beginArray();
+        }
+        columnValues.resize(options.shape == TableShape::Columns ? quotedKeys.size() : 0);
+    };
+
+    // һУstoredΪձʾڱûд洢
+    auto handleRow = [&](size_t row_index, const XlsxRow* stored) {
+        if (row_index == 1 && extractor.columns() == 0 && stored && stored->count > 0) {
+            // ȱ<dimension>ʱԵһеĿΪ׼
+            extractor.setColumns(stored->cells[stored->count - 1].column);
+        }
+        {
+            StageTimer timer(stats.seconds[ConvertStats::Extract]);
+            // ͷǰַȡƸʽԭֵ
+            extractor.extract(stored, (options.typedValues || binary) && row_index != 1);
+        }
+
+        if (row_index == 1) {
+            header.build(extractor);
+            // ÿһжҪдת
+            for (auto& field : header.fields) {
+                quotedKeys.emplace_back();
+                json.quote(header.key(field), quotedKeys.back());
+            }
+            if (callbacks.onHeader) callbacks.onHeader(sheetName, header.keys);
+            if (keyed) {
+                auto found = std::find_if(header.fields.begin(), header.fields.end(),
+                    [&](const XlsxHeader::Field& field) { return header.key(field) == options.keyColumn; });
+                if (found == header.fields.end()) {
+                    throw std::runtime_error("key column not found: " + options.keyColumn);
+                }
+                keyColumn = found->valueColumn;
+                keyIndex.reserve(max_row);
+            }
+            beginDocument();
+            return;
+        }
+
+        // ֵȴûظʱűʧ
+        if (keyed) {
+            if (extractor.empty()) return;
+            if (!extractor.hasValue(keyColumn)) {
+                throw std::runtime_error("row " + std::to_string(row_index) + " has no value in key column " + options.keyColumn);
+            }
+            std::string_view key = extractor.value(keyColumn);
+            uint32_t firstRow = keyIndex.insert(key, static_cast<uint32_t>(row_index));
+            if (firstRow != 0) {
+                throw std::runtime_error("duplicate key " + std::string(key) + " in rows " +
+                    std::to_string(firstRow) + " and " + std::to_string(row_index));
+            }
+        }
+
+        // е˳ֱֵӴӰкĻȡ
+        {
+            StageTimer timer(stats.seconds[ConvertStats::Json]);
+            if (keyed && !binary) json.key(extractor.value(keyColumn));
+            if (binary) {
+                packRow();
+            } else if (options.shape == TableShape::Objects) {
+                if (!keyed && !lines && rows == 0) json.beginArray();
+                json.beginObject();
+                for (size_t i = 0; i < header.fields.size(); ++i) {
+                    size_t column = header.fields[i].valueColumn;
+                    if (options.omitEmpty && !extractor.hasValue(column)) continue;
+                    json.quotedKey(quotedKeys[i]);
+                    writeValue(column);
+                }
+                json.endObject();
+                if (lines) json.raw("\n");
+            } else if (options.shape == TableShape::Rows) {
+                json.beginArray();
+                for (auto& field : header.fields) writeValue(field.valueColumn);
+                json.endArray();
+                if (lines) json.raw("\n");
+            } else {
+                for (size_t i = 0; i < header.fields.size(); ++i) {
+                    appendValue(header.fields[i].valueColumn, columnValues[i]);
+                }
+            }
+        }
+        if (++rows % kProgressInterval == 0 && callbacks.onRows) {
+            callbacks.onRows(sheetName, kProgressInterval);
+        }
+    };
+
+    // кŲʱУȡĽһ
+    size_t row_index = 1;
+    auto handleBatch = [&](const RowBatch& batch) {
+        TraceScope trace("serialize", "stage");
+        for (size_t i = 0; i < batch.count; ++i) {
+            const XlsxRow& row = batch.rows[i];
+            for (; row_index < row.index; ++row_index) {
+                handleRow(row_index, nullptr);
+            }
+            handleRow(row_index++, &row);
+        }
+    };
+
+    auto finishJson = [&]() {
+        if (rows % kProgressInterval != 0 && callbacks.onRows) {
+            callbacks.onRows(sheetName, rows % kProgressInterval);
+        }
+        if (!begun) beginDocument();
+        if (binary) {
+            packer->flush();
+            return;
+        }
+        if (options.shape == TableShape::Columns) {
+            StageTimer timer(stats.seconds[ConvertStats::Json]);
+            json.key("data");
+            json.beginObject();
+            for (size_t i = 0; i < quotedKeys.size(); ++i) {
+                json.quotedKey(quotedKeys[i]);
+                json.beginArray();
+                std::string_view values = columnValues[i];
+                for (size_t begin = 0, end; begin < values.size(); begin = end + 1) {
+                    end = values.find('\0', begin);
+                    json.literal(values.substr(begin, end - begin));
+                }
+                json.endArray();
+            }
+            json.endObject();
+        }
+        if (!lines) {
+            if (options.shape == TableShape::Objects) {
+                if (keyed) json.endObject();
+                else if (rows == 0) json.literal("null");
+                else json.endArray();
+            } else {
+                if (options.shape == TableShape::Rows) {
+                    if (keyed) json.endObject();
+                    else json.endArray();
+                }
+                json.endObject();
+            }
+            json.raw("\n");
+        }
+        json.flush();
+    };
+
+    if (pipelined) {
+        SpscQueue<RowBatch> fullBatches(kBatchCount);
+        SpscQueue<RowBatch> freeBatches(kBatchCount);
+        for (size_t i = 0; i < kBatchCount; ++i) freeBatches.push(RowBatch());
+        for (size_t i = 0; i < kChunkCount; ++i) freeChunks.push(std::string());
+
+        // һʱرжУ漴˳
+        auto stopAll = [&]() {
+            fullBatches.close();
+            freeBatches.close();
+            fullChunks.close();
+            freeChunks.close();
+        };
+
+        StageTask parseStage([&]() {
+            RowBatch batch;
+            while (freeBatches.pop(batch) && fillBatch(batch)) {
+                if (!fullBatches.push(std::move(batch))) return;
+            }
+            fullBatches.close();
+        }, stopAll);
+
+        StageTask writeStage([&]() {
+            std::string chunk;
+            while (fullChunks.pop(chunk)) {
+                writeChunk(chunk);
+                freeChunks.push(std::move(chunk));
+            }
+        }, stopAll);
+
+        pipelined = StageTask::startAll(*pool, { &parseStage, &writeStage });
+        if (pipelined) {
+            // Ȼβ׳ǳһԼ쳣
+            try {
+                RowBatch batch;
+                while (fullBatches.pop(batch)) {
+                    handleBatch(batch);
+                    freeBatches.push(std::move(batch));
+                }
+                parseStage.join();
+                finishJson();
+                fullChunks.close();
+            } catch (...) {
+                stopAll();
+                writeStage.join();
+                throw;
+            }
+            writeStage.join();
+        }
+    }
+    if (!pipelined) {
+        RowBatch batch;
+        while (fillBatch(batch)) handleBatch(batch);
+        finishJson();
+    }
+
+    if (binary) {
+        // ռλԪظļݱˣժҪ´ļ
+        std::string count = packer->countHeader(keyed, static_cast<uint32_t>(rows));
+        outPut.seekp(static_cast<std::streamoff>(countOffset));
+        outPut.write(count.data(), count.size());
+    } else {
+        encoder.finish(gbkChunk);
+        writeChunk(std::string_view());
+    }
+    outPut.close();
+    if (!outPut) {
+        throw std::runtime_error("write failed: " + PathToUtf8(tmpPath));
+    }
+    uint64_t outputDigest = binary ? Hash64::ofFile(tmpPath) : outputHash.digest();
+
+    fs::rename(tmpPath, desPath);
+    tmpGuard.commit();
+
+    result.rows += rows;
+    result.outputBytes += outputBytes;
+    result.outputs.push_back(ConvertOutput{ desPath, outputBytes, outputDigest, fingerprint, false });
+    if (callbacks.onSheetDone) callbacks.onSheetDone(sheetName, desPath);
+}
+
+} // namespace
+
+ConvertResult Xlsx2Json(const fs::path& srcPath, const fs::path& desPath,
+    const ConvertOptions& options, const ConvertCallbacks& callbacks, ThreadPool* pool) {
+    TraceScope traceWorkbook("workbook", "convert", srcPath);
+    auto start = Clock::now();
+    ConvertResult result;
+    result.inputBytes = fs::file_size(srcPath);
+    result.stats.bytes[ConvertStats::Open] = result.inputBytes;
+
+    // ֻȡԪݣʽ룬ٹ
+    // ַʽȷйҪתٶ
+    if (options.shape == TableShape::Columns && options.layout == JsonLayout::Lines) {
+        throw std::runtime_error("columnar output cannot be written as NDJSON");
+    }
+    if (!options.keyColumn.empty() && (options.shape == TableShape::Columns || options.layout == JsonLayout::Lines)) {
+        throw std::runtime_error("keyed output needs the objects or rows shape and a non-NDJSON layout");
+    }
+    if (options.format != OutputFormat::Json && (options.shape == TableShape::Columns || options.layout == JsonLayout::Lines)) {
+        throw std::runtime_error("binary output needs the objects or rows shape and a non-NDJSON layout");
+    }
+
+    XlsxWorkbook wb(srcPath, false);
+    result.stats.seconds[ConvertStats::Open] = std::chrono::duration<double>(Clock::now() - start).count();
+    auto finish = [&]() {
+        result.stats.totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    };
+
+    // ҪתĹԵ·
+    std::vector<std::pair<size_t, fs::path>> selected;
+    if (!options.allSheets) {
+        selected.emplace_back(wb.activeSheet(), desPath);
+    } else {
+        // ͬı滻ַܵõͬһļ"a/b""a_b"תʱдͬһʱļ
+        // е˳򣬺ֵļ_2_3ִСдȽϣWindowsļϵͳһ
+        std::unordered_set<std::string> usedPaths;
+        auto claimPath = [&](const fs::path& path) {
+            std::string key = PathToUtf8(path);
+            std::transform(key.begin(), key.end(), key.begin(), [](char ch) { return ch >= 'A' && ch <= 'Z' ? ch - 'A' + 'a' : ch; });
+            return usedPaths.insert(key).second;
+        };
+        for (size_t i = 0; i < wb.sheets().size(); ++i) {
+            auto& name = wb.sheets()[i].name;
+            if (options.sheets.empty() || std::find(options.sheets.begin(), options.sheets.end(), name) != options.sheets.end()) {
+                fs::path sheetPath = SheetOutputPath(desPath, name);
+                for (int suffix = 2; !claimPath(sheetPath); ++suffix) {
+                    sheetPath = SheetOutputPath(desPath, name + "_" + std::to_string(suffix));
+                }
+                selected.emplace_back(i, sheetPath);
+            }
+        }
+        for (auto& name : options.sheets) {
+            auto found = std::find_if(wb.sheets().begin(), wb.sheets().end(), [&](const XlsxSheetInfo& info) { return info.name == name; });
+            if (found == wb.sheets().end() && callbacks.onSheetMissing) {
+                callbacks.onSheetMissing(name);
+            }
+        }
+    }
+    result.sheets = selected.size();
+
+    // Ŀ¼CRC32ûĹϴεʣµĲҪѹ
+    std::vector<std::pair<size_t, fs::path>> pending;
+    std::vector<uint64_t> fingerprints;
+    for (auto& [sheetIndex, sheetPath] : selected) {
+        uint64_t fingerprint = wb.sheetFingerprint(sheetIndex, !options.rawValues);
+        if (callbacks.canReuseSheet && callbacks.canReuseSheet(wb.sheets()[sheetIndex].name, sheetPath, fingerprint)) {
+            result.outputs.push_back(ConvertOutput{ sheetPath, 0, 0, fingerprint, true });
+            ++result.reusedSheets;
+        } else {
+            pending.emplace_back(sheetIndex, sheetPath);
+            fingerprints.push_back(fingerprint);
+        }
+    }
+    if (pending.empty()) return finish();
+
+    {
+        TraceScope trace("shared parts", "stage");
+        StageTimer timer(result.stats.seconds[ConvertStats::SharedParts]);
+        wb.loadSharedParts(!options.rawValues);
+        result.stats.bytes[ConvertStats::SharedParts] = wb.sharedPartsSize();
+    }
+
+    if (!options.allSheets) {
+        ConvertSheet(wb, pending[0].first, pending[0].second, fingerprints[0], options, callbacks, pool, result);
+        return finish();
+    }
+
+    // ÿɰܣһʧܲӰͳƺٻ
+    std::vector<ConvertResult> sheetResults(pending.size());
+    auto convertOne = [&](size_t i) {
+        size_t sheetIndex = pending[i].first;
+        auto& sheetName = wb.sheets()[sheetIndex].name;
+        try {
+            ConvertSheet(wb, sheetIndex, pending[i].second, fingerprints[i], options, callbacks, pool, sheetResults[i]);
+        } catch (const std::exception& e) {
+            sheetResults[i].failedSheets = 1;
+            if (callbacks.onSheetError) callbacks.onSheetError(sheetName, e.what());
+        }
+    };
+    if (pool) {
+        pool->parallelFor(pending.size(), convertOne);
+    } else {
+        for (size_t i = 0; i < pending.size(); ++i) convertOne(i);
+    }
+
+    for (auto& sheetResult : sheetResults) {
+        result.failedSheets += sheetResult.failedSheets;
+        result.rows += sheetResult.rows;
+        result.outputBytes += sheetResult.outputBytes;
+        result.outputs.insert(result.outputs.end(), sheetResult.outputs.begin(), sheetResult.outputs.end());
+        result.stats.merge(sheetResult.stats);
+    }
+    return finish();
+}
+
+// ============================ ͳ ============================
+
+void ConvertStats::merge(const ConvertStats& other) {
+    for (int i = 0; i < StageCount; ++i) {
+        seconds[i] += other.seconds[i];
+        bytes[i] += other.bytes[i];
+    }
+}
+
+std::string FormatConvertStats(const ConvertResult& result) {
+    static const char* const stageNames[ConvertStats::StageCount] = {
+        "open", "shared", "parse", "extract", "json", "transcode", "write"
+    };
+    const ConvertStats& stats = result.stats;
+    const double mb = 1024.0 * 1024.0;
+    auto rate = [](double amount, double seconds) { return seconds > 0 ? amount / seconds : 0.0; };
+
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "%zu rows in %.1f ms, %.0f rows/s, %.1f MB/s in, %.1f MB/s out",
+        result.rows, stats.totalSeconds * 1000, rate(static_cast<double>(result.rows), stats.totalSeconds),
+        rate(result.inputBytes / mb, stats.totalSeconds), rate(result.outputBytes / mb, stats.totalSeconds));
+    std::string text = buffer;
+
+    for (int i = 0; i < ConvertStats::StageCount; ++i) {
+        if (stats.seconds[i] <= 0 && stats.bytes[i] == 0) continue;
+        std::snprintf(buffer, sizeof(buffer), " | %s %.1f ms", stageNames[i], stats.seconds[i] * 1000);
+        text += buffer;
+        // ֻĿ¼ٶû壻ȡмʱ/׶
+        if (i == ConvertStats::Open) {
+            continue;
+        } else if (i == ConvertStats::Extract) {
+            std::snprintf(buffer, sizeof(buffer), " %.0f rows/s", rate(static_cast<double>(result.rows), stats.seconds[i]));
+        } else {
+            std::snprintf(buffer, sizeof(buffer), " %.1f MB %.1f MB/s", stats.bytes[i] / mb, rate(stats.bytes[i] / mb, stats.seconds[i]));
+        }
+        text += buffer;
+    }
+    return text;
+}
+
+// ============================ ߺ ============================
+
+std::string ConvertOptionsKey(const ConvertOptions& options) {
+    std::string key = "v" + std::to_string(kConverterVersion);
+    if (options.allSheets) {
+        key += " sheets=";
+        key += options.sheets.empty() ? "*" : "";
+        for (size_t i = 0; i < options.sheets.size(); ++i) {
+            if (i > 0) key += ',';
+            key += options.sheets[i];
+        }
+    } else {
+        key += " sheets=active";
+    }
+    if (options.typedValues) key += " typed";
+    if (options.omitEmpty) key += " omit-empty";
+    if (options.rawValues) key += " raw";
+    if (options.shape == TableShape::Rows) key += " shape=rows";
+    else if (options.shape == TableShape::Columns) key += " shape=columns";
+    if (!options.keyColumn.empty()) key += " key=" + options.keyColumn;
+    if (options.layout == JsonLayout::Compact) key += " compact";
+    else if (options.layout == JsonLayout::Lines) key += " ndjson";
+    if (options.format == OutputFormat::MessagePack) key += " format=msgpack";
+    else if (options.format == OutputFormat::Cbor) key += " format=cbor";
+    return key;
+}
+
+fs::path OutputExtension(const ConvertOptions& options) {
+    if (options.format == OutputFormat::MessagePack) return ".msgpack";
+    if (options.format == OutputFormat::Cbor) return ".cbor";
+    return options.layout == JsonLayout::Lines ? ".ndjson" : ".json";
+}
+
+fs::path changeFileExtension(const fs::path& path, const fs::path& newExtension) {
+    fs::path result = path;
+    return result.replace_extension(newExtension);
+}
+
+fs::path SheetOutputPath(const fs::path& desPath, const std::string& sheetName) {
+    std::string name = sheetName;
+    for (auto& ch : name) {
+        if (std::string_view("<>:\"/\\|?*").find(ch) != std::string_view::npos || (ch >= 0 && ch < 0x20)) ch = '_';
+    }
+    fs::path result = desPath.parent_path() / desPath.stem();
+    result += "_";
+    result += PathFromUtf8(name);
+    result += desPath.extension();
+    return result;
+}
+
+std::vector<std::string> ParseSheetList(const std::string& text) {
+    std::vector<std::string> names;
+    std::istringstream iss(text);
+    std::string name;
+    while (std::getline(iss, name, ',')) {
+        size_t first = name.find_first_not_of(" \t");
+        size_t last = name.find_last_not_of(" \t");
+        if (first != std::string::npos) names.push_back(name.substr(first, last - first + 1));
+    }
+    return names;
+}
+
+fs::path PathFromUtf8(const std::string& text) {
+    return fs::path(std::u8string(text.begin(), text.end()));
+}
+
+std::string PathToUtf8(const fs::path& path) {
+    std::u8string text = path.u8string();
+    return std::string(text.begin(), text.end());
+}
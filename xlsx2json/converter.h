@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class XlsxWorkbook;
+
+// ============================ ת ============================
+
+/**
+ * Ű棺Prettyjsoncpp"\t"һ£CompactհףLinesÿһNDJSON
+ */
+enum class JsonLayout {
+    Pretty,
+    Compact,
+    Lines
+};
+
+/**
+ * Ľṹ
+ * Objects  [{"k1":v,"k2":v},...]ÿһ
+ * Rows     {"columns":["k1","k2"],"rows":[[v,v],...]}ֻдһΣNDJSONʱһΪ飬֮ÿһ
+ * Columns  {"columns":["k1","k2"],"data":{"k1":[v,...],"k2":[v,...]}}ÿһͬ飬űתд
+ */
+enum class TableShape {
+    Objects,
+    Rows,
+    Columns
+};
+
+/**
+ * ʽMessagePackCBORĽṹJSONͬtypedValuesԭֵַΪUTF-8ȥ
+ * Ƹʽֻ֧ObjectsRowslayout
+ */
+enum class OutputFormat {
+    Json,
+    MessagePack,
+    Cbor
+};
+
+/**
+ * תѡ
+ */
+struct ConvertOptions {
+    bool allSheets = false;             // תȫÿ
+    std::vector<std::string> sheets;    // allSheetsʱֻתЩΪձʾȫ
+    bool typedValues = false;           // 벼ֵΪJSONԭֵյԪnull""
+    bool omitEmpty = false;             // յԪֻObjectsЧ
+    bool rawValues = false;             // ȡԪ洢ԭʼֵָʽȾҲstyles.xml
+    JsonLayout layout = JsonLayout::Pretty;
+    TableShape shape = TableShape::Objects;     // ColumnsJsonLayout::Linesͬʱʹ
+    // ǿʱObjectsΪ{"":{...}}Rows"rows"Ϊ{"":[...]}ظȱʧʱñתʧ
+    // ColumnsJsonLayout::Linesͬʱʹ
+    std::string keyColumn;
+    OutputFormat format = OutputFormat::Json;   // ƸʽColumnsJsonLayout::Linesͬʱʹ
+};
+
+/**
+ * תе֪ͨɽоʾallSheetsʱڹ߳е
+ */
+struct ConvertCallbacks {
+    std::function<void(const std::string& sheet, size_t columns, size_t rows)> onSheetBegin;
+    std::function<void(const std::string& sheet, const std::vector<std::string>& keys)> onHeader;
+    std::function<void(const std::string& sheet, size_t rows)> onRows;    // дrowsУÿ1024֪ͨһ
+    std::function<void(const std::string& sheet, const std::filesystem::path& output)> onSheetDone;
+    std::function<void(const std::string& sheet, const std::string& error)> onSheetError;
+    std::function<void(const std::string& sheet)> onSheetMissing;
+
+    // תǰָѯϴεܷãtrueʱٽѹͽù
+    std::function<bool(const std::string& sheet, const std::filesystem::path& output, uint64_t fingerprint)> canReuseSheet;
+};
+
+/**
+ * дһļhashΪݵXXH64fingerprintΪĹָ
+ * reusedʾϴεʱbyteshashΪ0ɵ÷Լļ¼в
+ */
+struct ConvertOutput {
+    std::filesystem::path path;
+    uint64_t bytes = 0;
+    uint64_t hash = 0;
+    uint64_t fingerprint = 0;
+    bool reused = false;
+};
+
+/**
+ * ׶εĺʱ
+ * bytesOpenΪxlsxļСSharedPartsParseΪѹXMLJsonΪлUTF-8ıݣTranscodeWriteΪGBK
+ * Ƹʽת룬ûTranscode׶ΣWriteΪԭдֽ
+ * ˮʱ׶ڲͬ߳ͬʱУ׶κʱ֮ͻtotalSeconds
+ */
+struct ConvertStats {
+    enum Stage { Open, SharedParts, Parse, Extract, Json, Transcode, Write, StageCount };
+
+    double seconds[StageCount] = {};
+    uint64_t bytes[StageCount] = {};
+    double totalSeconds = 0;
+
+    void merge(const ConvertStats& other);
+};
+
+/**
+ * һתĽ
+ */
+struct ConvertResult {
+    size_t sheets = 0;
+    size_t failedSheets = 0;
+    size_t reusedSheets = 0;
+    size_t rows = 0;
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+    std::vector<ConvertOutput> outputs;
+    ConvertStats stats;
+};
+
+/**
+ * ExcelתJSON
+ * ĬֻתdesPathoptions.allSheetsʱÿpoolʱ̳߳ͬʱд
+ */
+ConvertResult Xlsx2Json(const std::filesystem::path& srcPath, const std::filesystem::path& desPath,
+    const ConvertOptions& options = ConvertOptions(), const ConvertCallbacks& callbacks = ConvertCallbacks(),
+    ThreadPool* pool = nullptr);
+
+/**
+ * һֵͳժҪ/롢MB/Լ׶εĺʱٶ
+ */
+std::string FormatConvertStats(const ConvertResult& result);
+
+/**
+ * Ӱݵѡת汾д嵥һ仯ת
+ */
+std::string ConvertOptionsKey(const ConvertOptions& options);
+
+/**
+ * ʽչ".json"NDJSONΪ".ndjson"ƸʽΪ".msgpack"".cbor"
+ */
+std::filesystem::path OutputExtension(const ConvertOptions& options);
+
+/**
+ * ޸ļչ
+ */
+std::filesystem::path changeFileExtension(const std::filesystem::path& path, const std::filesystem::path& newExtension);
+
+/**
+ * ·<ļ>_<>.jsonļвַ滻Ϊ'_'
+ * ͬһ滻ıXlsx2Jsonֵı_2_3
+ */
+std::filesystem::path SheetOutputPath(const std::filesystem::path& desPath, const std::string& sheetName);
+
+/**
+ * ŷָĹ
+ */
+std::vector<std::string> ParseSheetList(const std::string& text);
+
+/**
+ * UTF-8 ַ·תWindowsϰشҳ
+ */
+std::filesystem::path PathFromUtf8(const std::string& text);
+std::string PathToUtf8(const std::filesystem::path& path);
@@ -0,0 +1,154 @@
+#include "gbk_encoder.h"
+#include "gbk_table.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XLSX2JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+
+namespace {
+
+/**
+ * pʼASCIIֽڵĳ
+ */
+size_t AsciiPrefix(const char* p, size_t size) {
+    size_t i = 0;
+#ifdef XLSX2JSON_SSE2
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        int mask = _mm_movemask_epi8(block);
+        if (mask != 0) {
+            while ((mask & 1) == 0) {
+                mask >>= 1;
+                ++i;
+            }
+            return i;
+        }
+    }
+#else
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, sizeof(word));
+        if (word & 0x8080808080808080ull) break;
+    }
+#endif
+    while (i < size && static_cast<unsigned char>(p[i]) < 0x80) ++i;
+    return i;
+}
+
+/**
+ * ֽڵõUTF-8гȣǷֽڷ0
+ */
+size_t SequenceLength(unsigned char lead) {
+    if (lead < 0x80) return 1;
+    if (lead >= 0xC2 && lead <= 0xDF) return 2;
+    if (lead >= 0xE0 && lead <= 0xEF) return 3;
+    if (lead >= 0xF0 && lead <= 0xF4) return 4;
+    return 0;
+}
+
+/**
+ * һĶֽУǷʱ0xFFFFFFFF
+ */
+unsigned DecodeSequence(const unsigned char* p, size_t length) {
+    unsigned code = p[0] & (0x7F >> length);
+    for (size_t k = 1; k < length; ++k) {
+        if ((p[k] & 0xC0) != 0x80) return 0xFFFFFFFF;
+        code = (code << 6) | (p[k] & 0x3F);
+    }
+    return code;
+}
+
+} // namespace
+
+void GbkEncoder::encodeCodePoint(unsigned code, std::string& out) {
+    uint16_t gbk = 0;
+    if (code < 0x10000) {
+        uint8_t page = kGbkPageIndex[code >> 8];
+        if (page) gbk = kGbkPages[page - 1][code & 0xFF];
+    }
+
+    if (gbk == 0) {
+        out += '?';
+    } else if (gbk < 0x100) {
+        out += static_cast<char>(gbk);
+    } else {
+        out += static_cast<char>(gbk >> 8);
+        out += static_cast<char>(gbk & 0xFF);
+    }
+}
+
+void GbkEncoder::encode(std::string_view input, std::string& out) {
+    const char* p = input.data();
+    size_t size = input.size();
+    size_t i = 0;
+    out.reserve(out.size() + size);
+
+    // Ȳһַ
+    if (pendingSize > 0) {
+        size_t length = SequenceLength(static_cast<unsigned char>(pending[0]));
+        while (pendingSize < length && i < size) {
+            unsigned char next = static_cast<unsigned char>(p[i]);
+            if ((next & 0xC0) != 0x80) break;
+            pending[pendingSize++] = p[i++];
+        }
+        if (pendingSize < length && i == size) return;
+
+        if (pendingSize == length) {
+            unsigned code = DecodeSequence(reinterpret_cast<unsigned char*>(pending), length);
+            if (code == 0xFFFFFFFF) out += '?';
+            else encodeCodePoint(code, out);
+        } else {
+            out += '?';
+        }
+        pendingSize = 0;
+    }
+
+    while (i < size) {
+        size_t run = AsciiPrefix(p + i, size - i);
+        if (run > 0) {
+            out.append(p + i, run);
+            i += run;
+            continue;
+        }
+
+        size_t length = SequenceLength(static_cast<unsigned char>(p[i]));
+        if (length == 0) {
+            out += '?';
+            ++i;
+            continue;
+        }
+        if (i + length > size) {
+            // βһ
+            pendingSize = size - i;
+            std::memcpy(pending, p + i, pendingSize);
+            return;
+        }
+
+        unsigned code = DecodeSequence(reinterpret_cast<const unsigned char*>(p + i), length);
+        if (code == 0xFFFFFFFF) {
+            out += '?';
+            ++i;
+            continue;
+        }
+        encodeCodePoint(code, out);
+        i += length;
+    }
+}
+
+void GbkEncoder::finish(std::string& out) {
+    if (pendingSize > 0) {
+        out += '?';
+        pendingSize = 0;
+    }
+}
+
+std::string Utf8ToGbk(std::string_view utf8_str) {
+    std::string gbk_str;
+    GbkEncoder encoder;
+    encoder.encode(utf8_str, gbk_str);
+    encoder.finish(gbk_str);
+    return gbk_str;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// ============================ GBK ת ============================
+
+/**
+ * UTF-8 -> GBK ʽתʵ֣WindowsҳAPI
+ * ASCIIֱο֧SSE2ʱÿμ16ֽڣ
+ * п飬βUTF-8ַᱣһencode
+ */
+class GbkEncoder {
+public:
+    GbkEncoder() : pendingSize(0) {}
+
+    // תһ벢׷ӵout
+    void encode(std::string_view input, std::string& out);
+
+    // ĲַΪ'?'
+    void finish(std::string& out);
+
+private:
+    void encodeCodePoint(unsigned code, std::string& out);
+
+    char pending[4];
+    size_t pendingSize;
+};
+
+/**
+ *  UTF-8 ת GBK޷ӳַΪ'?'
+ */
+std::string Utf8ToGbk(std::string_view utf8_str);
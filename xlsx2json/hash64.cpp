@@ -0,0 +1,147 @@
+#include "hash64.h"
+#include "converter.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+const uint64_t kPrime3 = 0x165667B19E3779F9ull;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+const uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+uint64_t Rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t Load64(const unsigned char* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+uint32_t Load32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = Rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+uint64_t MergeRound(uint64_t acc, uint64_t value) {
+    acc ^= Round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+Hash64::Hash64(uint64_t seed) : tailSize(0), totalSize(0), seed(seed) {
+    lanes[0] = seed + kPrime1 + kPrime2;
+    lanes[1] = seed + kPrime2;
+    lanes[2] = seed;
+    lanes[3] = seed - kPrime1;
+}
+
+void Hash64::update(const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalSize += size;
+
+    if (tailSize + size < 32) {
+        std::memcpy(tail + tailSize, p, size);
+        tailSize += size;
+        return;
+    }
+
+    if (tailSize > 0) {
+        size_t fill = 32 - tailSize;
+        std::memcpy(tail + tailSize, p, fill);
+        for (int i = 0; i < 4; ++i) lanes[i] = Round(lanes[i], Load64(tail + i * 8));
+        p += fill;
+        size -= fill;
+        tailSize = 0;
+    }
+
+    while (size >= 32) {
+        for (int i = 0; i < 4; ++i) lanes[i] = Round(lanes[i], Load64(p + i * 8));
+        p += 32;
+        size -= 32;
+    }
+
+    std::memcpy(tail, p, size);
+    tailSize = size;
+}
+
+uint64_t Hash64::digest() const {
+    uint64_t hash;
+    if (totalSize >= 32) {
+        hash = Rotl(lanes[0], 1) + Rotl(lanes[1], 7) + Rotl(lanes[2], 12) + Rotl(lanes[3], 18);
+        for (int i = 0; i < 4; ++i) hash = MergeRound(hash, lanes[i]);
+    } else {
+        hash = seed + kPrime5;
+    }
+    hash += totalSize;
+
+    const unsigned char* p = tail;
+    size_t size = tailSize;
+    while (size >= 8) {
+        hash ^= Round(0, Load64(p));
+        hash = Rotl(hash, 27) * kPrime1 + kPrime4;
+        p += 8;
+        size -= 8;
+    }
+    if (size >= 4) {
+        hash ^= static_cast<uint64_t>(Load32(p)) * kPrime1;
+        hash = Rotl(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+        size -= 4;
+    }
+    while (size > 0) {
+        hash ^= (*p) * kPrime5;
+        hash = Rotl(hash, 11) * kPrime1;
+        ++p;
+        --size;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Hash64::ofFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open " + PathToUtf8(path));
+    }
+
+    Hash64 hasher;
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hasher.update(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+    return hasher.digest();
+}
+
+std::string HashToHex(uint64_t hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        text[i] = digits[hash & 0xF];
+        hash >>= 4;
+    }
+    return text;
+}
+
+uint64_t HashFromHex(const std::string& text) {
+    return std::strtoull(text.c_str(), nullptr, 16);
+}
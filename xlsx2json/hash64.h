@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// ============================ ݹϣ ============================
+
+/**
+ * XXH64 ʽϣжԴļǷ仯
+ */
+class Hash64 {
+public:
+    explicit Hash64(uint64_t seed = 0);
+
+    void update(const void* data, size_t size);
+    uint64_t digest() const;
+
+    // ȡļϣ򲻿ʱ׳쳣
+    static uint64_t ofFile(const std::filesystem::path& path);
+
+private:
+    uint64_t lanes[4];
+    unsigned char tail[32];
+    size_t tailSize;
+    uint64_t totalSize;
+    uint64_t seed;
+};
+
+std::string HashToHex(uint64_t hash);
+uint64_t HashFromHex(const std::string& text);
@@ -0,0 +1,211 @@
+#include "json_writer.h"
+
+namespace {
+
+const char kHexDigits[] = "0123456789abcdef";
+
+void AppendHex16(std::pmr::string& out, unsigned code) {
+    out += "\\u";
+    out += kHexDigits[(code >> 12) & 0xF];
+    out += kHexDigits[(code >> 8) & 0xF];
+    out += kHexDigits[(code >> 4) & 0xF];
+    out += kHexDigits[code & 0xF];
+}
+
+bool NeedsEscaping(std::string_view text) {
+    for (unsigned char c : text) {
+        if (c == '\\' || c == '"' || c < 0x20 || c > 0x7F) return true;
+    }
+    return false;
+}
+
+/**
+ * һUTF-8ַǷзU+FFFDֻǰһֽ
+ */
+unsigned DecodeUtf8(std::string_view text, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    if (length == 1 || i + length > text.size()) {
+        ++i;
+        return c < 0x80 ? c : 0xFFFD;
+    }
+    unsigned code = c & (0x3F >> (length - 1));
+    for (size_t k = 1; k < length; ++k) {
+        unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80) {
+            ++i;
+            return 0xFFFD;
+        }
+        code = (code << 6) | (next & 0x3F);
+    }
+    i += length;
+    return code;
+}
+
+} // namespace
+
+JsonWriter::JsonWriter(const JsonWriterSettings& settings, Sink sink, size_t flushSize, std::pmr::memory_resource* memory)
+    : settings(settings), sink(std::move(sink)), flushSize(flushSize), buffer(memory), afterKey(false) {
+    buffer.reserve(flushSize + 4096);
+}
+
+void JsonWriter::writeIndent() {
+    if (settings.indentation.empty()) return;
+    buffer += '\n';
+    buffer += indentString;
+}
+
+void JsonWriter::beforeValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (scopes.empty()) return;
+
+    Scope& scope = scopes.back();
+    if (scope.count > 0) buffer += ',';
+    writeIndent();
+    ++scope.count;
+}
+
+void JsonWriter::afterToken() {
+    if (buffer.size() >= flushSize) flush();
+}
+
+void JsonWriter::beginArray() {
+    beforeValue();
+    buffer += '[';
+    scopes.push_back(Scope{ true, 0 });
+    indentString += settings.indentation;
+}
+
+void JsonWriter::endArray() {
+    size_t count = scopes.back().count;
+    scopes.pop_back();
+    indentString.resize(indentString.size() - settings.indentation.size());
+    if (count > 0) writeIndent();
+    buffer += ']';
+    afterToken();
+}
+
+void JsonWriter::beginObject() {
+    beforeValue();
+    buffer += '{';
+    scopes.push_back(Scope{ false, 0 });
+    indentString += settings.indentation;
+}
+
+void JsonWriter::endObject() {
+    size_t count = scopes.back().count;
+    scopes.pop_back();
+    indentString.resize(indentString.size() - settings.indentation.size());
+    if (count > 0) writeIndent();
+    buffer += '}';
+    afterToken();
+}
+
+void JsonWriter::beforeKey() {
+    Scope& scope = scopes.back();
+    if (scope.count > 0) buffer += ',';
+    writeIndent();
+    ++scope.count;
+}
+
+void JsonWriter::key(std::string_view name) {
+    beforeKey();
+    quote(name, buffer);
+    buffer += settings.indentation.empty() ? ":" : " : ";
+    afterKey = true;
+}
+
+void JsonWriter::value(std::string_view text) {
+    beforeValue();
+    quote(text, buffer);
+    afterToken();
+}
+
+void JsonWriter::quotedKey(std::string_view quoted) {
+    beforeKey();
+    buffer.append(quoted.data(), quoted.size());
+    buffer += settings.indentation.empty() ? ":" : " : ";
+    afterKey = true;
+}
+
+void JsonWriter::quotedValue(std::string_view quoted) {
+    beforeValue();
+    buffer.append(quoted.data(), quoted.size());
+    afterToken();
+}
+
+void JsonWriter::literal(std::string_view text) {
+    beforeValue();
+    buffer.append(text.data(), text.size());
+    afterToken();
+}
+
+void JsonWriter::raw(std::string_view text) {
+    buffer.append(text.data(), text.size());
+    afterToken();
+}
+
+void JsonWriter::flush() {
+    if (buffer.empty()) return;
+    sink(buffer);
+    buffer.clear();
+}
+
+/**
+ * תjsoncppvalueToQuotedStringNͬ
+ */
+void JsonWriter::quote(std::string_view text, std::pmr::string& out) const {
+    out += '"';
+    if (!NeedsEscaping(text)) {
+        out.append(text.data(), text.size());
+        out += '"';
+        return;
+    }
+
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+        case '"': out += "\\\""; ++i; continue;
+        case '\\': out += "\\\\"; ++i; continue;
+        case '\b': out += "\\b"; ++i; continue;
+        case '\f': out += "\\f"; ++i; continue;
+        case '\n': out += "\\n"; ++i; continue;
+        case '\r': out += "\\r"; ++i; continue;
+        case '\t': out += "\\t"; ++i; continue;
+        default: break;
+        }
+
+        if (c < 0x20) {
+            AppendHex16(out, c);
+            ++i;
+        } else if (c < 0x80 || settings.emitUTF8) {
+            out += static_cast<char>(c);
+            ++i;
+        } else {
+            unsigned code = DecodeUtf8(text, i);
+            if (code > 0xFFFF) {
+                code -= 0x10000;
+                AppendHex16(out, 0xD800 + ((code >> 10) & 0x3FF));
+                AppendHex16(out, 0xDC00 + (code & 0x3FF));
+            } else {
+                AppendHex16(out, code);
+            }
+        }
+    }
+    out += '"';
+}
+
+// ============================ JsonQuotedCache ============================
+
+std::string_view JsonQuotedCache::get(size_t index, std::string_view text) {
+    Span& span = spans[index];
+    if (span.length == 0) {
+        span.offset = quoted.size();
+        writer.quote(text, quoted);
+        span.length = quoted.size() - span.offset;
+    }
+    return std::string_view(quoted).substr(span.offset, span.length);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================ JSON ʽ ============================
+
+/**
+ *  Json::StreamWriterBuilder  indentation / emitUTF8 ͬ
+ */
+struct JsonWriterSettings {
+    std::string indentation = "\t";
+    bool emitUTF8 = true;
+};
+
+/**
+ * ʽJSONJson::Valueд߰ݽ
+ * Ű Json::StreamWriterBuilder ɵĽֽһ£
+ * ӼڵпʼjsoncppȻУԭṹû
+ * εÿһ鶼ļǺ֮ضϣпUTF-8ַ
+ */
+class JsonWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    // memory
+    JsonWriter(const JsonWriterSettings& settings, Sink sink, size_t flushSize = 64 * 1024,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    void beginArray();
+    void endArray();
+    void beginObject();
+    void endObject();
+    void key(std::string_view name);
+    void value(std::string_view text);
+
+    // дѾquoteӺŲתļֵֵַıֻתһ
+    void quotedKey(std::string_view quoted);
+    void quotedValue(std::string_view quoted);
+    void quote(std::string_view text, std::pmr::string& out) const;
+
+    // ԭдһֵ֡truefalsenull
+    void literal(std::string_view text);
+
+    // ֱдԭʼıļĩβĻ
+    void raw(std::string_view text);
+    void flush();
+
+private:
+    struct Scope {
+        bool isArray;
+        size_t count;
+    };
+
+    void beforeKey();
+    void beforeValue();
+    void writeIndent();
+    void afterToken();
+
+    JsonWriterSettings settings;
+    Sink sink;
+    size_t flushSize;
+    std::pmr::string buffer;
+    std::string indentString;
+    std::vector<Scope> scopes;
+    bool afterKey;
+};
+
+/**
+ * ŻӺŲתַÿŵһõʱת壬֮θ
+ * ڹַöػıڱзֵֵgetصͼһget֮ǰЧ
+ */
+class JsonQuotedCache {
+public:
+    JsonQuotedCache(const JsonWriter& writer, size_t count, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : writer(writer), spans(count, memory), quoted(memory) {}
+
+    std::string_view get(size_t index, std::string_view text);
+
+private:
+    struct Span {
+        size_t offset = 0;
+        size_t length = 0;      // ֽڣ0ʾûл
+    };
+
+    const JsonWriter& writer;
+    std::pmr::vector<Span> spans;
+    std::pmr::string quoted;
+};
@@ -0,0 +1,56 @@
+#include "key_index.h"
+#include "hash64.h"
+#include <algorithm>
+
+namespace {
+
+const size_t kMinCapacity = 64;
+
+uint64_t HashKey(std::string_view key) {
+    Hash64 hasher;
+    hasher.update(key.data(), key.size());
+    return hasher.digest();
+}
+
+} // namespace
+
+KeyIndex::KeyIndex(std::pmr::memory_resource* memory) : slots(memory), keys(memory), count(0) {
+}
+
+void KeyIndex::reserve(size_t expected) {
+    size_t capacity = kMinCapacity;
+    while (capacity < expected * 2) capacity <<= 1;
+    if (capacity > slots.size()) rehash(capacity);
+}
+
+uint32_t KeyIndex::insert(std::string_view key, uint32_t row) {
+    if ((count + 1) * 2 > slots.size()) rehash(std::max(kMinCapacity, slots.size() * 2));
+
+    uint64_t hash = HashKey(key);
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.row == 0) {
+            slot = Slot{ hash, keys.size(), static_cast<uint32_t>(key.size()), row };
+            keys.append(key.data(), key.size());
+            ++count;
+            return 0;
+        }
+        if (slot.hash == hash && keyAt(slot) == key) return slot.row;
+    }
+}
+
+/**
+ * Ϊ2ݣɲλĹϣֱ·ãټϣ
+ */
+void KeyIndex::rehash(size_t capacity) {
+    std::pmr::vector<Slot> old(capacity, Slot{}, slots.get_allocator());
+    old.swap(slots);
+    size_t mask = capacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.row == 0) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].row != 0) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================  ============================
+
+/**
+ * Ѱַ̽⣩ϣıβӴһڴ
+ * ֻ벻ɾһɨзظزһ룬̽кܶ
+ */
+class KeyIndex {
+public:
+    explicit KeyIndex(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // ԤƵļһηòλɨ;ؽ
+    void reserve(size_t count);
+
+    // ɹ0Ѵʱ룬һγʱкţrow0
+    uint32_t insert(std::string_view key, uint32_t row);
+
+    size_t size() const { return count; }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        uint64_t offset;
+        uint32_t length;
+        uint32_t row;       // 0ʾղ
+    };
+
+    std::string_view keyAt(const Slot& slot) const { return std::string_view(keys).substr(slot.offset, slot.length); }
+    void rehash(size_t capacity);
+
+    std::pmr::vector<Slot> slots;
+    std::pmr::string keys;
+    size_t count;
+};
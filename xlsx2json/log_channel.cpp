@@ -0,0 +1,129 @@
+#include "log_channel.h"
+#include <cstdio>
+#include <ctime>
+
+namespace fs = std::filesystem;
+
+// ============================ LogTimeFormatter ============================
+
+LogTimeFormatter::LogTimeFormatter()
+    : wallStart(std::chrono::system_clock::now()), steadyStart(std::chrono::steady_clock::now()), cachedSecond(-1) {
+}
+
+const std::string& LogTimeFormatter::format(std::chrono::steady_clock::time_point time) {
+    auto wall = wallStart + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - steadyStart);
+    int64_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(wall.time_since_epoch()).count();
+    int64_t second = millis / 1000;
+
+    if (second != cachedSecond) {
+        std::time_t seconds = static_cast<std::time_t>(second);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+        cachedPrefix = buffer;
+        cachedSecond = second;
+    }
+
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%03d", static_cast<int>(millis % 1000));
+    text = cachedPrefix;
+    text += fraction;
+    return text;
+}
+
+// ============================ LogFileSink ============================
+
+LogFileSink::LogFileSink(const fs::path& path, uint64_t maxBytes, int keepFiles)
+    : filePath(path), maxBytes(maxBytes), keepFiles(keepFiles), fileBytes(0), signal(0), stopping(false) {
+    file.open(filePath, std::ios::binary | std::ios::app);
+    std::error_code ec;
+    fileBytes = fs::exists(filePath, ec) ? fs::file_size(filePath, ec) : 0;
+    thread = std::thread([this]() { run(); });
+}
+
+LogFileSink::~LogFileSink() {
+    stopping = true;
+    signal.store(1);
+    signal.notify_one();
+    thread.join();
+}
+
+void LogFileSink::push(LogEvent event) {
+    queue.push(std::move(event));
+    // ֻд߳̿˯ʱŻ
+    if (signal.exchange(1) == 0) signal.notify_one();
+}
+
+void LogFileSink::run() {
+    for (;;) {
+        signal.wait(0);
+        signal.store(0);
+        bool stop = stopping;
+
+        LogEvent event;
+        bool wrote = false;
+        while (queue.pop(event)) {
+            write(event);
+            wrote = true;
+        }
+        if (wrote) file.flush();
+        if (stop) return;
+    }
+}
+
+void LogFileSink::write(const LogEvent& event) {
+    static const char* const levelNames[] = { "INFO ", "WARN ", "ERROR" };
+
+    if (!file) return;
+    if (fileBytes >= maxBytes) rotate();
+
+    const std::string& time = formatter.format(event.time);
+    const char* level = levelNames[static_cast<int>(event.level)];
+    file << time << ' ' << level << ' ' << event.text << '\n';
+    fileBytes += time.size() + 7 + event.text.size() + 1;
+}
+
+fs::path LogFileSink::rotatedPath(int index) const {
+    fs::path path = filePath.parent_path() / filePath.stem();
+    path += "." + std::to_string(index);
+    path += filePath.extension();
+    return path;
+}
+
+/**
+ * name.log -> name.1.log -> name.2.log ...ɵһɾ
+ */
+void LogFileSink::rotate() {
+    file.close();
+    std::error_code ec;
+    fs::remove(rotatedPath(keepFiles), ec);
+    for (int i = keepFiles - 1; i >= 1; --i) {
+        fs::rename(rotatedPath(i), rotatedPath(i + 1), ec);
+    }
+    fs::rename(filePath, keepFiles > 0 ? rotatedPath(1) : filePath, ec);
+    file.open(filePath, std::ios::binary | std::ios::trunc);
+    fileBytes = 0;
+}
+
+// ============================ LogChannel ============================
+
+LogChannel::LogChannel() = default;
+
+void LogChannel::openFile(const fs::path& path, uint64_t maxBytes, int keepFiles) {
+    fileSink = std::make_unique<LogFileSink>(path, maxBytes, keepFiles);
+}
+
+void LogChannel::closeFile() {
+    fileSink.reset();
+}
+
+void LogChannel::publish(LogLevel level, std::string text) {
+    LogEvent event{ std::chrono::steady_clock::now(), level, std::move(text) };
+    if (fileSink) fileSink->push(event);
+    queue.push(std::move(event));
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "mpsc_queue.h"
+
+// ============================ ־ͨ ============================
+
+enum class LogLevel : uint8_t {
+    Info,
+    Warning,
+    Error
+};
+
+/**
+ * һ־ʱȡʱӣʱκθʽ
+ */
+struct LogEvent {
+    std::chrono::steady_clock::time_point time;
+    LogLevel level = LogLevel::Info;
+    std::string text;
+};
+
+/**
+ * ѵʱӻɱʱı "2024-01-02 13:45:06.789"
+ * ͬһֻһlocaltimeÿ̸߳һ
+ */
+class LogTimeFormatter {
+public:
+    LogTimeFormatter();
+
+    const std::string& format(std::chrono::steady_clock::time_point time);
+
+private:
+    std::chrono::system_clock::time_point wallStart;
+    std::chrono::steady_clock::time_point steadyStart;
+    int64_t cachedSecond;
+    std::string cachedPrefix;
+    std::string text;
+};
+
+/**
+ * ̨־ļԼ߳дļmaxBytesʱתΪ name.1.log ... name.<keepFiles>.log
+ */
+class LogFileSink {
+public:
+    LogFileSink(const std::filesystem::path& path, uint64_t maxBytes, int keepFiles);
+    ~LogFileSink();
+
+    LogFileSink(const LogFileSink&) = delete;
+    LogFileSink& operator=(const LogFileSink&) = delete;
+
+    // ̵߳ã
+    void push(LogEvent event);
+
+private:
+    void run();
+    void write(const LogEvent& event);
+    void rotate();
+    std::filesystem::path rotatedPath(int index) const;
+
+    std::filesystem::path filePath;
+    uint64_t maxBytes;
+    int keepFiles;
+    std::ofstream file;
+    uint64_t fileBytes;
+    LogTimeFormatter formatter;
+
+    MpscQueue<LogEvent> queue;
+    std::atomic<uint32_t> signal;
+    std::atomic<bool> stopping;
+    std::thread thread;
+};
+
+/**
+ * ־ͨ߳طṹ¼߳ÿ֡ȡһΣͬʱ̨ļ
+ */
+class LogChannel {
+public:
+    LogChannel();
+
+    // ʼͬʱд־ļκ̷֮߳ǰ
+    void openFile(const std::filesystem::path& path, uint64_t maxBytes = 1 << 20, int keepFiles = 3);
+    // дʣ־رļз֮߳̽
+    void closeFile();
+
+    // ̵߳
+    void publish(LogLevel level, std::string text);
+
+    // ֻһ̣̣߳߳
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        LogEvent event;
+        while (queue.pop(event)) fn(event);
+    }
+
+private:
+    MpscQueue<LogEvent> queue;
+    std::unique_ptr<LogFileSink> fileSink;
+};
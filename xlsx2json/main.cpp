@@ -1,13 +1,15 @@
 #include <iostream>
 #include <random>
 #include <string>
-#include <iomanip>
+#include <cstdlib>
 #include <chrono>
 #include <vector>
 #include <fstream>
 #include <sstream>
-#include <xlnt/xlnt.hpp>
-#include <json/json.h>
+#include "converter.h"
+#include "thread_pool.h"
+#include "log_channel.h"
+#include "trace.h"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -18,14 +20,87 @@
 #include <filesystem>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
 namespace fs = std::filesystem;
 
+// ============================ ־ ============================
+
+/**
+ * ̶־λ壬˸ɵһֻڽ̷߳
+ * ÿ־ֻռһУʱImGuiListClipperֻŰɼУٶ֡ʱҲ
+ */
+class LogRing {
+public:
+    struct Entry {
+        LogLevel level = LogLevel::Info;
+        std::string line;
+    };
+
+private:
+    std::vector<Entry> entries;
+    size_t next;    // һдλ
+    size_t count;
+
+public:
+    explicit LogRing(size_t capacity) : entries(capacity), next(0), count(0) {}
+
+    void push(const std::string& time, LogLevel level, const std::string& content) {
+        // ǾĿʱַ
+        Entry& entry = entries[next];
+        entry.level = level;
+        entry.line.assign(time);
+        entry.line.append("  ");
+        entry.line.append(content);
+        std::replace(entry.line.begin() + time.size(), entry.line.end(), '\n', ' ');
+        next = (next + 1) % entries.size();
+        count = std::min(count + 1, entries.size());
+    }
+
+    size_t size() const { return count; }
+
+    // indexµһ0Ϊ
+    const Entry& newest(size_t index) const {
+        return entries[(next + entries.size() - 1 - index) % entries.size()];
+    }
+};
+
 // ============================ ȫֱ ============================
-std::string logText = "";
+// ̷߳logChannel߳ÿ֡ȡŽlogRing
+LogChannel logChannel;
+LogRing logRing(4096);
+LogTimeFormatter logTimeFormatter;
+
+ConvertOptions convertOptions;
+char sheetFilter[256] = "";
+char keyColumn[128] = "";
+
+/**
+ * ļת񣺹̸߳½״̬߳ÿ֡ȡ
+ */
+struct ConvertJob {
+    enum State { Queued, Running, Done, Failed };
+    
+    std::string name;
+    fs::path srcPath;
+    fs::path desPath;
+    ConvertOptions options;
+    std::atomic<int> state{ Queued };
+    std::atomic<size_t> totalRows{ 0 };
+    std::atomic<size_t> doneRows{ 0 };
+    std::mutex messageMutex;
+    std::string message;
+};
+
+std::vector<std::shared_ptr<ConvertJob>> convertJobs;
+std::mutex jobsMutex;
+std::atomic<int> pendingCelebrations{ 0 };
+// ڹرպλŶӵļٿʼת˳ʱֻתļ
+std::atomic<bool> shuttingDown{ false };
 
 // ============================ ̻Ч ============================
 
@@ -589,48 +664,10 @@ std::unique_ptr<FireworkManager> fireworkManager;
 // ============================ ߺ ============================
 
 /**
- * ־¼
- */
-void LoggerDump(const char* content) {
-    logText.insert(0, "\n");
-    logText.insert(0, content);
-    logText.insert(0, "\t");
-    
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm* local_time = std::localtime(&now_c);
-    
-    std::ostringstream oss;
-    oss << std::put_time(local_time, "%c");
-    oss << "." << std::setfill('0') << std::setw(3) << millis.count() % 1000;
-    logText.insert(0, oss.str());
-}
-
-/**
- * UTF-8 ת GBK
+ * ־¼̵߳ãҲʽʱ
  */
-std::string Utf8ToGbk(const std::string& utf8_str) {
-    // UTF-8 ת UTF-16
-    int wide_size = MultiByteToWideChar(CP_UTF8, 0, utf8_str.c_str(), (int)utf8_str.size(), NULL, 0);
-    if (wide_size == 0) {
-        return utf8_str; // תʧܣԭַ
-    }
-    
-    std::vector<wchar_t> utf16_str(wide_size + 1, 0);
-    MultiByteToWideChar(CP_UTF8, 0, utf8_str.c_str(), (int)utf8_str.size(), &utf16_str[0], wide_size);
-    
-    // UTF-16 ת GBK
-    int gbk_size = WideCharToMultiByte(CP_ACP, 0, &utf16_str[0], wide_size, NULL, 0, NULL, NULL);
-    if (gbk_size == 0) {
-        return utf8_str; // תʧܣԭַ
-    }
-    
-    std::vector<char> gbk_str(gbk_size + 1, 0);
-    WideCharToMultiByte(CP_ACP, 0, &utf16_str[0], wide_size, &gbk_str[0], gbk_size, NULL, NULL);
-    
-    return std::string(&gbk_str[0]);
+void LoggerDump(const char* content, LogLevel level = LogLevel::Info) {
+    logChannel.publish(level, content);
 }
 
 /**
@@ -662,26 +699,23 @@ std::string WcharToChar(const std::wstring& wstr) {
         return "";
     }
 
+    // lenβ'\0'Žƴںݻᱻc_str()ص
     std::vector<char> mbstr(len);
     WideCharToMultiByte(CP_UTF8, 0, wccstr, -1, &mbstr[0], len, nullptr, nullptr);
-    return std::string(mbstr.begin(), mbstr.end());
+    return std::string(mbstr.data(), len - 1);
 }
 
 /**
- * ޸ļչ
+ * ImGui::Comboѡбÿ'\0'βбһ'\0'β
  */
-std::wstring changeFileExtension(const std::wstring& path, const std::wstring& newExtension) {
-    std::wstring baseName = fs::path(path).filename().wstring();
-    std::wstring extension = fs::path(path).extension().wstring();
-    
-    // Ƴԭʼչ
-    size_t dotPos = baseName.rfind('.');
-    if (dotPos != std::string::npos) {
-        baseName.erase(dotPos);
+std::string ComboItems(std::initializer_list<const wchar_t*> items) {
+    std::string result;
+    for (const wchar_t* item : items) {
+        result += WcharToChar(item);
+        result += '\0';
     }
-    
-    // չ
-    return fs::path(path).parent_path().wstring() + L"\\" + baseName + newExtension;
+    result += '\0';
+    return result;
 }
 
 // ============================ Ĺ ============================
@@ -700,77 +734,79 @@ std::string Join(const Container& container, const std::string& delimiter) {
     return oss.str();
 }
 
+// ȫֹ̳߳
+std::unique_ptr<ThreadPool> threadPool;
+
 /**
- * ExcelתJSON
+ * ڹ߳תһļд־дjob
  */
-void Xlsx2Json(std::wstring& srcPath, std::wstring& desPath) {
-    LoggerDump(WcharToChar(L"=================תʼ=================").c_str());
-    
-    xlnt::workbook wb;
-    wb.load(srcPath);
-    auto ws = wb.active_sheet();
-    auto dim = ws.calculate_dimension();
-    
-    size_t max_row = dim.height();
-    size_t max_column = dim.width();
-    
-    LoggerDump(WcharToChar(
-        std::wstring(L":") + std::to_wstring(max_column) + 
-        L"\t" + std::wstring(L":") + std::to_wstring(max_row)
-    ).c_str());
+void ConvertFile(ConvertJob& job) {
+    if (shuttingDown) return;
+    TraceScope trace("file", "gui", job.srcPath);
+    job.state = ConvertJob::Running;
+    LoggerDump((WcharToChar(L"=================תʼ================= ") + job.name).c_str());
     
-    Json::Value arr;
-    std::vector<std::string> keys;
+    ConvertCallbacks callbacks;
+    callbacks.onSheetBegin = [&job](const std::string& sheet, size_t columns, size_t rows) {
+        // һǱͷ
+        job.totalRows += rows > 0 ? rows - 1 : 0;
+        LoggerDump((sheet + WcharToChar(
+            std::wstring(L"\t:") + std::to_wstring(columns) + 
+            L"\t" + std::wstring(L":") + std::to_wstring(rows)
+        )).c_str());
+    };
+    callbacks.onHeader = [](const std::string& sheet, const std::vector<std::string>& keys) {
+        LoggerDump((std::string("[") + Join(keys, "],[") + std::string("]")).c_str());
+    };
+    callbacks.onRows = [&job](const std::string& sheet, size_t rows) {
+        job.doneRows += rows;
+    };
+    callbacks.onSheetDone = [](const std::string& sheet, const fs::path& output) {
+        LoggerDump(WcharToChar(std::wstring(L"ת ") + output.wstring()).c_str());
+    };
+    callbacks.onSheetError = [](const std::string& sheet, const std::string& error) {
+        LoggerDump((sheet + " Error:" + error).c_str(), LogLevel::Error);
+    };
+    callbacks.onSheetMissing = [](const std::string& sheet) {
+        LoggerDump((WcharToChar(L"Ҳ:") + sheet).c_str(), LogLevel::Warning);
+    };
     
-    // Excel
-    for (size_t row_index = 1; row_index <= max_row; ++row_index) {
-        Json::Value tab;
-        
-        for (int32_t col_index = 1; col_index <= max_column; ++col_index) {
-            xlnt::cell cell = ws.cell(col_index, row_index);
-            
-            if (row_index == 1) {
-                // һжȡ
-                keys.emplace_back(cell.to_string());
-            } else {
-                auto& key = keys[col_index - 1];
-                if (cell.has_value())
-                    tab[key] = cell.to_string();
-                else
-                    tab[key] = "";
-            }
-        }
-        
-        if (row_index == 1) {
-            LoggerDump((std::string("[") + Join(keys, "],[") + std::string("]")).c_str());
+    try {
+        ConvertResult result = Xlsx2Json(job.srcPath, job.desPath, job.options, callbacks, threadPool.get());
+        std::lock_guard<std::mutex> lock(job.messageMutex);
+        if (result.failedSheets > 0) {
+            job.message = std::to_string(result.failedSheets) + WcharToChar(L" ʧ");
+            job.state = ConvertJob::Failed;
         } else {
-            arr.append(tab);
+            job.message = std::to_string(result.rows) + WcharToChar(L" ");
+            job.state = ConvertJob::Done;
         }
+        LoggerDump((WcharToChar(L"ʱ ") + FormatConvertStats(result)).c_str());
+    } catch (const std::exception& e) {
+        LoggerDump((std::string("Error:") += e.what()).c_str(), LogLevel::Error);
+        std::lock_guard<std::mutex> lock(job.messageMutex);
+        job.message = e.what();
+        job.state = ConvertJob::Failed;
     }
     
-    // дJSONļ
-    Json::StreamWriterBuilder builder;
-    builder.settings_["indentation"] = "\t";
-    builder.settings_["emitUTF8"] = true;
-    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
-    
-    std::ostringstream ossJson;
-    writer->write(arr, &ossJson);
-    
-    // ֱʹ Utf8ToGbk ת
-    std::string gbkStr = Utf8ToGbk(ossJson.str());
-    
-    std::ofstream outPut(desPath.c_str());
-    outPut << gbkStr << std::endl;
-    
-    LoggerDump(WcharToChar(std::wstring(L"ת ") + desPath).c_str());
-    
-    // תʱһЩĭΪףЧ
-    if (bubbleManager) {
-        for (int i = 0; i < 8; ++i) {
-            bubbleManager->addBubble();
-        }
+    // ĭɽ߳
+    ++pendingCelebrations;
+}
+
+/**
+ * һļתУ
+ */
+void QueueConvert(const fs::path& srcPath) {
+    auto job = std::make_shared<ConvertJob>();
+    job->name = PathToUtf8(srcPath.filename());
+    job->srcPath = srcPath;
+    job->options = convertOptions;
+    job->desPath = changeFileExtension(srcPath, OutputExtension(job->options));
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        convertJobs.push_back(job);
     }
+    threadPool->submit([job]() { ConvertFile(*job); });
 }
 
 // ============================  ============================
@@ -788,13 +824,117 @@ void DrawConvertWindow() {
     
     ImGui::Begin(WcharToChar(std::wstring(L"xlsxļjson")).c_str(), nullptr, window_flags);
 
-    // ʾ־С壩
+    // ѡ
     ImGui::SetWindowFontScale(0.5);
-    ImGui::TextWrapped("%s", logText.c_str());
+    ImGui::Checkbox(WcharToChar(L"תȫ").c_str(), &convertOptions.allSheets);
+    if (convertOptions.allSheets) {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(300);
+        if (ImGui::InputTextWithHint("##sheets", WcharToChar(L"ֻתЩŷָ").c_str(), sheetFilter, sizeof(sheetFilter))) {
+            convertOptions.sheets = ParseSheetList(sheetFilter);
+        }
+    }
+    ImGui::Checkbox(WcharToChar(L"벼ֵΪJSONԭֵ").c_str(), &convertOptions.typedValues);
+    ImGui::SameLine();
+    ImGui::Checkbox(WcharToChar(L"ʡԿյԪ").c_str(), &convertOptions.omitEmpty);
+    ImGui::SameLine();
+    ImGui::Checkbox(WcharToChar(L"ԭʼֵָʽʾ").c_str(), &convertOptions.rawValues);
+    {
+        static const std::string layoutItems = ComboItems({ L"", L"", L"ÿһ(NDJSON)" });
+        int layout = static_cast<int>(convertOptions.layout);
+        ImGui::SetNextItemWidth(200);
+        if (ImGui::Combo(WcharToChar(L"Ű").c_str(), &layout, layoutItems.c_str())) {
+            convertOptions.layout = static_cast<JsonLayout>(layout);
+        }
+
+        static const std::string shapeItems = ComboItems({ L"ÿһ", L"+", L"" });
+        int shape = static_cast<int>(convertOptions.shape);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200);
+        if (ImGui::Combo(WcharToChar(L"ṹ").c_str(), &shape, shapeItems.c_str())) {
+            convertOptions.shape = static_cast<TableShape>(shape);
+        }
+    }
+    ImGui::SetNextItemWidth(300);
+    if (ImGui::InputTextWithHint("##key", WcharToChar(L"У").c_str(), keyColumn, sizeof(keyColumn))) {
+        convertOptions.keyColumn = keyColumn;
+    }
+    {
+        static const std::string formatItems = std::string("JSON") + '\0' + "MessagePack" + '\0' + "CBOR" + '\0' + '\0';
+        int format = static_cast<int>(convertOptions.format);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200);
+        if (ImGui::Combo(WcharToChar(L"ʽ").c_str(), &format, formatItems.c_str())) {
+            convertOptions.format = static_cast<OutputFormat>(format);
+        }
+    }
+    
+    // ת
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        bool anyFinished = false;
+        for (auto& job : convertJobs) {
+            int state = job->state;
+            size_t total = job->totalRows;
+            size_t done = job->doneRows;
+            std::string status;
+            if (state == ConvertJob::Queued) {
+                status = WcharToChar(L"Ŷ");
+            } else if (state == ConvertJob::Running) {
+                status = std::to_string(done) + " / " + std::to_string(total);
+            } else {
+                std::lock_guard<std::mutex> messageLock(job->messageMutex);
+                status = WcharToChar(state == ConvertJob::Done ? L" " : L"ʧ ") + job->message;
+                anyFinished = true;
+            }
+            float fraction = state >= ConvertJob::Done ? 1.0f : (total > 0 ? static_cast<float>(done) / total : 0.0f);
+            ImGui::ProgressBar(fraction, ImVec2(200, 0), status.c_str());
+            ImGui::SameLine();
+            ImGui::TextUnformatted(job->name.c_str());
+        }
+        if (anyFinished && ImGui::Button(WcharToChar(L"").c_str())) {
+            convertJobs.erase(std::remove_if(convertJobs.begin(), convertJobs.end(),
+                [](const std::shared_ptr<ConvertJob>& job) { return job->state >= ConvertJob::Done; }),
+                convertJobs.end());
+        }
+    }
+    
     ImGui::SetWindowFontScale(1);
+
+    // ȡһ֮֡ǰ־ʱŸʽ
+    logChannel.drain([](const LogEvent& event) {
+        logRing.push(logTimeFormatter.format(event.time), event.level, event.text);
+    });
+
+    // ʾ־С壩µ棬ֻƿɼ
+    ImGui::BeginChild("##log", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::SetWindowFontScale(0.5);
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(logRing.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            const LogRing::Entry& entry = logRing.newest(i);
+            if (entry.level == LogLevel::Info) {
+                ImGui::TextUnformatted(entry.line.data(), entry.line.data() + entry.line.size());
+            } else {
+                ImVec4 color = entry.level == LogLevel::Error ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImVec4(1.0f, 0.8f, 0.2f, 1.0f);
+                ImGui::PushStyleColor(ImGuiCol_Text, color);
+                ImGui::TextUnformatted(entry.line.data(), entry.line.data() + entry.line.size());
+                ImGui::PopStyleColor();
+            }
+        }
+    }
+    ImGui::EndChild();
     
     ImGui::End();
     
+    // תʱһЩĭΪףЧ
+    for (int count = pendingCelebrations.exchange(0); count > 0 && bubbleManager; --count) {
+        for (int i = 0; i < 8; ++i) {
+            bubbleManager->addBubble();
+        }
+    }
+    
     if (bubbleManager && fireworkManager) {
         ImDrawList* drawList = ImGui::GetBackgroundDrawList();
         bubbleManager->updateAndDraw(drawList, *fireworkManager);
@@ -844,15 +984,13 @@ public:
         HRESULT hr = pDataObj->GetData(&fmtetc, &stgmedium);
         if (SUCCEEDED(hr)) {
             HDROP hDrop = (HDROP)stgmedium.hGlobal;
-            wchar_t xlsxPath[MAX_PATH] = {0};
-            DragQueryFileW(hDrop, 0, xlsxPath, MAX_PATH);
             
-            try {
-                std::wstring srcPath = xlsxPath;
-                std::wstring desPath = changeFileExtension(xlsxPath, L".json");
-                Xlsx2Json(srcPath, desPath);
-            } catch (const std::exception& e) {
-                LoggerDump((std::string("Error:") += e.what()).c_str());
+            // ļ̣߳صأ治Ῠס
+            UINT fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
+            for (UINT i = 0; i < fileCount; ++i) {
+                wchar_t xlsxPath[MAX_PATH] = {0};
+                DragQueryFileW(hDrop, i, xlsxPath, MAX_PATH);
+                QueueConvert(xlsxPath);
             }
             
             DragFinish(hDrop);
@@ -897,6 +1035,15 @@ int main(int argc, char* argv[]) {
     // ʼ̻
     bubbleManager = std::make_unique<BubbleManager>(35);
     fireworkManager = std::make_unique<FireworkManager>();
+    logChannel.openFile("xlsx2json.log");
+
+    // û XLSX2JSON_TRACE=<ļ> ʱ¼ʱߣ˳ʱд
+    const char* tracePath = std::getenv("XLSX2JSON_TRACE");
+    if (tracePath && *tracePath) {
+        Trace::start();
+        Trace::setThreadName("ui");
+    }
+    threadPool = std::make_unique<ThreadPool>();
 
     OleInitialize(NULL);
     HWND hwnd = glfwGetWin32Window(window);
@@ -904,6 +1051,7 @@ int main(int argc, char* argv[]) {
     RegisterDragDrop(hwnd, &dm);
 
     while (!glfwWindowShouldClose(window)) {
+        TraceScope traceFrame("frame", "ui");
         glfwPollEvents();
 
         ImGui_ImplOpenGL3_NewFrame();
@@ -923,6 +1071,17 @@ int main(int argc, char* argv[]) {
         glfwSwapBuffers(window);
     }
 
+    shuttingDown = true;
+    threadPool.reset();
+    logChannel.closeFile();
+    if (Trace::enabled()) {
+        try {
+            Trace::writeJson(PathFromUtf8(tracePath));
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// ============================ ߵ߶ ============================
+
+/**
+ * ޽УVyukov MPSC߳pushֻһ߳pop
+ * pushֻһԭӽᱻ߻
+ * ߽ͷָ롢δnext˲䣬popʱԪأ´ȡ
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node()), tail(head.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        while (tail) {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        Node() : next(nullptr) {}
+        explicit Node(T&& value) : next(nullptr), value(std::move(value)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    std::atomic<Node*> head;    // ·Ľڵ㣬߽
+    Node* tail;                 // ȡߵڱڵ㣬ֻ߷
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================ ߵ߶ ============================
+
+/**
+ * нζУֻһ߳pushһ߳pop
+ * ʱpushȴʱpopȴC++20 atomic waitԴʵˮ߸֮ıѹ
+ * رձ־head/tailλ±ͬһԭϱ仯ȴر֪ͨ
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : head(0), tail(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * һԪأʱȴѹرʱfalse
+     */
+    bool push(T&& value) {
+        size_t t = tail.load(std::memory_order_relaxed) & kIndexMask;
+        for (;;) {
+            size_t h = head.load(std::memory_order_acquire);
+            if (h & kClosedBit) return false;
+            if (t - h <= mask) break;
+            head.wait(h, std::memory_order_acquire);
+        }
+        slots[t & mask] = std::move(value);
+        tail.fetch_add(1, std::memory_order_release);
+        tail.notify_one();
+        return true;
+    }
+
+    /**
+     * ȡһԪأпʱȴѹرȡպ󷵻false
+     */
+    bool pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed) & kIndexMask;
+        for (;;) {
+            size_t t = tail.load(std::memory_order_acquire);
+            if ((t & kIndexMask) != h) break;
+            if (t & kClosedBit) return false;
+            tail.wait(t, std::memory_order_acquire);
+        }
+        value = std::move(slots[h & mask]);
+        head.fetch_add(1, std::memory_order_release);
+        head.notify_one();
+        return true;
+    }
+
+    /**
+     * رնУ߲pushȡʣԪغһʱҲһ
+     */
+    void close() {
+        head.fetch_or(kClosedBit, std::memory_order_acq_rel);
+        tail.fetch_or(kClosedBit, std::memory_order_acq_rel);
+        head.notify_all();
+        tail.notify_all();
+    }
+
+private:
+    static constexpr size_t kClosedBit = size_t(1) << (sizeof(size_t) * 8 - 1);
+    static constexpr size_t kIndexMask = kClosedBit - 1;
+
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;   // һҪȡλãֻƽ
+    alignas(64) std::atomic<size_t> tail;   // һҪŵλãֻƽ
+};
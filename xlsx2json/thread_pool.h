@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================ ̳߳ ============================
+
+/**
+ * ̶СĹ̳߳
+ * parallelForĵԼҲȡڲٴεparallelFor
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::deque<std::function<void()>> startedTasks;    // tryStarttasksȡ
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t busy;        // ִĹ߳
+    bool stopping;
+
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency()) : busy(0), stopping(false) {
+        threadCount = std::max<size_t>(1, threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_all();
+    }
+
+    /**
+     * еĹ߳㹻ʱǲtrueһҲfalse
+     * ڻȴˮߵĸڱһֱỴ̄߳ɵ˳ִ
+     */
+    bool tryStart(std::vector<std::function<void()>> group) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (busy + tasks.size() + startedTasks.size() + group.size() > workers.size()) return false;
+            for (auto& task : group) startedTasks.push_back(std::move(task));
+        }
+        cv.notify_all();
+        return true;
+    }
+
+    /**
+     * ִ fn(0) ... fn(count - 1) ȴȫɣһ쳣ڽ׳
+     * ÿεԼ±й̴߳ȡߵȴʱֻ
+     * ȡǶ׵ãÿļٰУѱļѹԼջ
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return;
+
+        // ڶİֿڱУ״̬ǹͬУ쵽±ʱfnһЧ
+        struct Batch {
+            const std::function<void(size_t)>* fn;
+            size_t count;
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> remaining;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+
+            Batch(const std::function<void(size_t)>& fn, size_t count) : fn(&fn), count(count), remaining(count) {}
+
+            // ȡִбʣµ±ֱ꣬
+            void run() {
+                for (size_t i; (i = next++) < count;) {
+                    try {
+                        (*fn)(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) error = std::current_exception();
+                    }
+                    if (--remaining == 0) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        done.notify_all();
+                    }
+                }
+            }
+        };
+        auto batch = std::make_shared<Batch>(fn, count);
+
+        size_t helpers = std::min(count - 1, workers.size());
+        for (size_t i = 0; i < helpers; ++i) {
+            submit([batch]() { batch->run(); });
+        }
+
+        batch->run();
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->done.wait(lock, [&]() { return batch->remaining == 0; });
+        if (batch->error) std::rethrow_exception(batch->error);
+    }
+
+private:
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [this]() { return stopping || !tasks.empty() || !startedTasks.empty(); });
+            auto& queue = startedTasks.empty() ? tasks : startedTasks;
+            if (queue.empty()) return;
+            auto task = std::move(queue.front());
+            queue.pop_front();
+            ++busy;
+            lock.unlock();
+            task();
+            lock.lock();
+            --busy;
+        }
+    }
+};
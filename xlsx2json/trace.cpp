@@ -0,0 +1,169 @@
+#include "trace.h"
+#include "converter.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ÿ߳ౣ¼ⳤʱ俪ʱڴ
+const size_t kMaxEventsPerThread = 1 << 20;
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    Clock::time_point start;
+    Clock::duration duration;
+    std::string detail;
+};
+
+/**
+ * һ̵߳¼壬ֻ߳׷
+ * ߳̽󻺳registryֱд֮½߳̽ã¼䣬
+ * ߳ٶ࣬ʱϵĹҲͬʱڵ߳
+ */
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::string name;
+    std::vector<TraceEvent> events;
+    size_t dropped = 0;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+std::vector<ThreadBuffer*> released;    // ߳ѽĻ
+Clock::time_point traceStart;
+
+/**
+ * ߳̽ʱѻŻreleased
+ */
+struct LocalBufferOwner {
+    ThreadBuffer* buffer = nullptr;
+
+    ~LocalBufferOwner() {
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        released.push_back(buffer);
+    }
+};
+
+thread_local LocalBufferOwner localBuffer;
+
+ThreadBuffer& LocalBuffer() {
+    if (!localBuffer.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!released.empty()) {
+            localBuffer.buffer = released.back();
+            released.pop_back();
+        } else {
+            registry.push_back(std::make_unique<ThreadBuffer>());
+            localBuffer.buffer = registry.back().get();
+            localBuffer.buffer->tid = static_cast<uint32_t>(registry.size());
+            localBuffer.buffer->events.reserve(1024);
+        }
+    }
+    return *localBuffer.buffer;
+}
+
+void AppendEscaped(std::string& out, const std::string& text) {
+    for (unsigned char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += static_cast<char>(ch);
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out += escaped;
+        } else {
+            out += static_cast<char>(ch);
+        }
+    }
+}
+
+double Microseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+std::atomic<bool> Trace::active(false);
+
+void Trace::start() {
+    traceStart = Clock::now();
+    active.store(true, std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const char* name) {
+    if (enabled()) LocalBuffer().name = name;
+}
+
+void Trace::record(const char* name, const char* category, Clock::time_point start, Clock::time_point end, std::string detail) {
+    ThreadBuffer& buffer = LocalBuffer();
+    if (buffer.events.size() >= kMaxEventsPerThread) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.events.push_back(TraceEvent{ name, category, start, end - start, std::move(detail) });
+}
+
+void Trace::writeJson(const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot write trace " + PathToUtf8(path));
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    char number[96];
+    auto separator = [&]() {
+        if (!first) out += ",\n";
+        first = false;
+    };
+
+    for (auto& buffer : registry) {
+        separator();
+        std::string threadName = buffer->name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->name;
+        std::snprintf(number, sizeof(number), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer->tid);
+        out += number;
+        AppendEscaped(out, threadName);
+        out += "\"}}";
+
+        for (auto& event : buffer->events) {
+            separator();
+            out += "{\"name\":\"";
+            AppendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            AppendEscaped(out, event.category);
+            std::snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                buffer->tid, Microseconds(event.start - traceStart), Microseconds(event.duration));
+            out += number;
+            if (!event.detail.empty()) {
+                out += ",\"args\":{\"detail\":\"";
+                AppendEscaped(out, event.detail);
+                out += "\"}";
+            }
+            out += '}';
+
+            if (out.size() >= (1 << 20)) {
+                file << out;
+                out.clear();
+            }
+        }
+
+        if (buffer->dropped > 0) {
+            separator();
+            std::snprintf(number, sizeof(number), "{\"name\":\"dropped %zu events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":0}",
+                buffer->dropped, buffer->tid);
+            out += number;
+        }
+    }
+    out += "\n]}\n";
+    file << out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+// ============================ ʱ߸ ============================
+
+/**
+ * ѡʱ߸٣Chrome/Perfettotrace¼JSONchrome://tracingui.perfetto.devֱӴ򿪣
+ * ÿ߳дԼĻ壬δʱÿٵֻһrelaxedԭӶ
+ */
+class Trace {
+public:
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    static void start();
+
+    // ǰ߳ʱʾ
+    static void setThreadName(const char* name);
+
+    // д̵߳ĿǰΪֹ¼ʱ̲߳ڼ¼
+    static void writeJson(const std::filesystem::path& path);
+
+    // TraceScope
+    static void record(const char* name, const char* category, std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end, std::string detail);
+
+private:
+    static std::atomic<bool> active;
+};
+
+/**
+ * ٣쵽֮ΪһΣdetailʾ¼УֻڿʱŸ
+ * namecategoryַ
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category)
+        : name(name), category(category), active(Trace::enabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+
+    TraceScope(const char* name, const char* category, const std::string& detail)
+        : TraceScope(name, category) {
+        if (active) this->detail = detail;
+    }
+
+    TraceScope(const char* name, const char* category, const std::filesystem::path& detail)
+        : TraceScope(name, category) {
+        if (active) {
+            std::u8string text = detail.u8string();
+            this->detail.assign(text.begin(), text.end());
+        }
+    }
+
+    ~TraceScope() {
+        if (active) Trace::record(name, category, start, std::chrono::steady_clock::now(), std::move(detail));
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+    std::string detail;
+};
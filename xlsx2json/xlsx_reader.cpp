@@ -0,0 +1,788 @@
+#include "xlsx_reader.h"
+#include "hash64.h"
+#include <xlnt/xlnt.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+const size_t kReadChunkSize = 64 * 1024;
+
+std::string_view LocalName(std::string_view name) {
+    size_t colon = name.find(':');
+    return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+void AppendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * XMLʵ壬û'&'ʱֱӿ
+ */
+void DecodeEntities(std::string_view raw, std::string& out) {
+    out.clear();
+    size_t amp = raw.find('&');
+    if (amp == std::string_view::npos) {
+        out.assign(raw.data(), raw.size());
+        return;
+    }
+
+    size_t start = 0;
+    while (amp != std::string_view::npos) {
+        out.append(raw.data() + start, amp - start);
+        size_t semi = raw.find(';', amp);
+        if (semi == std::string_view::npos) {
+            start = amp;
+            break;
+        }
+        std::string_view entity = raw.substr(amp + 1, semi - amp - 1);
+        if (entity == "lt") out += '<';
+        else if (entity == "gt") out += '>';
+        else if (entity == "amp") out += '&';
+        else if (entity == "quot") out += '"';
+        else if (entity == "apos") out += '\'';
+        else if (!entity.empty() && entity[0] == '#') {
+            bool hex = entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X');
+            std::string digits(entity.substr(hex ? 2 : 1));
+            AppendUtf8(out, static_cast<uint32_t>(std::strtoul(digits.c_str(), nullptr, hex ? 16 : 10)));
+        } else {
+            out.append(raw.data() + amp, semi - amp + 1);
+        }
+        start = semi + 1;
+        amp = raw.find('&', start);
+    }
+    out.append(raw.data() + start, raw.size() - start);
+}
+
+/**
+ * ϵļеTargetԴĿ¼
+ */
+std::string ResolvePartPath(const std::string& sourcePart, const std::string& target) {
+    if (!target.empty() && target[0] == '/') return target.substr(1);
+
+    std::vector<std::string> parts;
+    size_t slash = sourcePart.rfind('/');
+    std::string combined = (slash == std::string::npos ? "" : sourcePart.substr(0, slash + 1)) + target;
+
+    size_t start = 0;
+    while (start <= combined.size()) {
+        size_t end = combined.find('/', start);
+        if (end == std::string::npos) end = combined.size();
+        std::string segment = combined.substr(start, end - start);
+        if (segment == "..") {
+            if (!parts.empty()) parts.pop_back();
+        } else if (!segment.empty() && segment != ".") {
+            parts.push_back(segment);
+        }
+        start = end + 1;
+    }
+
+    std::string result;
+    for (auto& part : parts) {
+        if (!result.empty()) result += '/';
+        result += part;
+    }
+    return result;
+}
+
+std::string RelsPathFor(const std::string& part) {
+    size_t slash = part.rfind('/');
+    if (slash == std::string::npos) return "_rels/" + part + ".rels";
+    return part.substr(0, slash + 1) + "_rels/" + part.substr(slash + 1) + ".rels";
+}
+
+bool EndsWith(const std::string& value, std::string_view suffix) {
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool IsTrue(const std::string* value) {
+    return value && (*value == "1" || *value == "true");
+}
+
+struct Relationship {
+    std::string type;
+    std::string target;
+};
+
+/**
+ * ȡϵļ Id -> (Type, Ĳ·)
+ */
+std::unordered_map<std::string, Relationship> ReadRelationships(const ZipArchive& zip, const std::string& sourcePart) {
+    std::unordered_map<std::string, Relationship> result;
+    const ZipEntry* entry = zip.find(RelsPathFor(sourcePart));
+    if (!entry) return result;
+
+    XmlReader xml(zip.open(*entry));
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event != XmlReader::Event::StartElement || xml.name() != "Relationship") continue;
+        const std::string* id = xml.attribute("Id");
+        const std::string* type = xml.attribute("Type");
+        const std::string* target = xml.attribute("Target");
+        if (!id || !target) continue;
+        result[*id] = Relationship{ type ? *type : "", ResolvePartPath(sourcePart, *target) };
+    }
+    return result;
+}
+
+XlsxCellType CellTypeFromAttribute(const std::string* type) {
+    if (!type || type->empty() || *type == "n") return XlsxCellType::Number;
+    if (*type == "s") return XlsxCellType::SharedString;
+    if (*type == "str") return XlsxCellType::FormulaString;
+    if (*type == "inlineStr") return XlsxCellType::InlineString;
+    if (*type == "b") return XlsxCellType::Boolean;
+    if (*type == "e") return XlsxCellType::Error;
+    if (*type == "d") return XlsxCellType::Date;
+    return XlsxCellType::Number;
+}
+
+uint32_t RowIndexFromReference(std::string_view reference) {
+    uint32_t row = 0;
+    for (char c : reference) {
+        if (c >= '0' && c <= '9') row = row * 10 + static_cast<uint32_t>(c - '0');
+    }
+    return row;
+}
+
+/**
+ * <v>еָдΪ̵ʾ"1.0000000000000001E-2" -> "0.01"
+ * ޵ʮʱfalseɵַ߰numberΪֵ
+ */
+bool ShortestNumber(const std::string& raw, std::pmr::string& out, double& number) {
+    const char* end = raw.data() + raw.size();
+    auto parsed = std::from_chars(raw.data(), end, number);
+    if (parsed.ec != std::errc() || parsed.ptr != end || !std::isfinite(number)) return false;
+
+    char buffer[32];
+    auto written = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out.assign(buffer, written.ptr);
+    return true;
+}
+
+} // namespace
+
+uint32_t ColumnIndexFromReference(std::string_view reference) {
+    uint32_t column = 0;
+    for (char c : reference) {
+        if (c >= 'A' && c <= 'Z') column = column * 26 + static_cast<uint32_t>(c - 'A' + 1);
+        else if (c >= 'a' && c <= 'z') column = column * 26 + static_cast<uint32_t>(c - 'a' + 1);
+        else if (c != '$') break;
+    }
+    return column;
+}
+
+// ============================ XmlReader ============================
+
+XmlReader::XmlReader(std::unique_ptr<ZipEntryStream> stream)
+    : stream(std::move(stream)), pos(0), eof(false), pendingEnd(false), attributeCount(0) {
+    buffer.reserve(kReadChunkSize * 2);
+}
+
+/**
+ * ѵݲ׷һݣpos
+ */
+bool XmlReader::refill() {
+    if (eof) return false;
+    if (pos > 0) {
+        buffer.erase(0, pos);
+        pos = 0;
+    }
+    size_t oldSize = buffer.size();
+    buffer.resize(oldSize + kReadChunkSize);
+    size_t count = stream->read(&buffer[oldSize], kReadChunkSize);
+    buffer.resize(oldSize + count);
+    if (count == 0) eof = true;
+    return count > 0;
+}
+
+bool XmlReader::ensure(size_t count) {
+    while (buffer.size() - pos < count) {
+        if (!refill()) return false;
+    }
+    return true;
+}
+
+/**
+ * pos'<'ʼҵƥ'>'ڵ'>'
+ */
+size_t XmlReader::findTagEnd() {
+    size_t i = pos + 1;
+    char quote = 0;
+    for (;;) {
+        for (; i < buffer.size(); ++i) {
+            char c = buffer[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                return i;
+            }
+        }
+        size_t offset = i - pos;
+        if (!refill()) throw std::runtime_error("xml: unterminated tag");
+        i = pos + offset;
+    }
+}
+
+void XmlReader::skipUntil(std::string_view terminator) {
+    for (;;) {
+        size_t found = buffer.find(terminator, pos);
+        if (found != std::string::npos) {
+            pos = found + terminator.size();
+            return;
+        }
+        // ܱضϵֹǰ׺
+        if (buffer.size() - pos > terminator.size()) pos = buffer.size() - terminator.size();
+        if (!refill()) throw std::runtime_error("xml: unterminated markup");
+    }
+}
+
+void XmlReader::parseTag(size_t end) {
+    const char* p = buffer.data() + pos + 1;
+    const char* tagEnd = buffer.data() + end;
+    bool closing = false;
+    if (*p == '/') {
+        closing = true;
+        ++p;
+    }
+
+    const char* nameStart = p;
+    while (p < tagEnd && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '/') ++p;
+    std::string_view name = LocalName(std::string_view(nameStart, p - nameStart));
+    elementName.assign(name.data(), name.size());
+
+    attributeCount = 0;
+    bool selfClosing = tagEnd > p && *(tagEnd - 1) == '/';
+    if (selfClosing) --tagEnd;
+
+    while (!closing && p < tagEnd) {
+        while (p < tagEnd && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+        if (p >= tagEnd) break;
+        const char* attrStart = p;
+        while (p < tagEnd && *p != '=' && *p != ' ') ++p;
+        std::string_view attrName = LocalName(std::string_view(attrStart, p - attrStart));
+        while (p < tagEnd && *p != '"' && *p != '\'') ++p;
+        if (p >= tagEnd) break;
+        char quote = *p++;
+        const char* valueStart = p;
+        while (p < tagEnd && *p != quote) ++p;
+
+        if (attributeCount == attributes.size()) attributes.emplace_back();
+        Attribute& attr = attributes[attributeCount++];
+        attr.name.assign(attrName.data(), attrName.size());
+        DecodeEntities(std::string_view(valueStart, p - valueStart), attr.value);
+        ++p;
+    }
+
+    pendingEnd = selfClosing;
+    pos = end + 1;
+}
+
+XmlReader::Event XmlReader::next() {
+    if (pendingEnd) {
+        pendingEnd = false;
+        attributeCount = 0;
+        return Event::EndElement;
+    }
+
+    for (;;) {
+        if (pos >= buffer.size() && !refill()) return Event::End;
+
+        if (buffer[pos] != '<') {
+            // ıڵ㣺һ'<'Ϊֹ
+            size_t lt;
+            for (;;) {
+                lt = buffer.find('<', pos);
+                if (lt != std::string::npos || !refill()) break;
+            }
+            if (lt == std::string::npos) lt = buffer.size();
+            DecodeEntities(std::string_view(buffer.data() + pos, lt - pos), textValue);
+            pos = lt;
+            return Event::Text;
+        }
+
+        if (!ensure(4)) throw std::runtime_error("xml: unexpected end of document");
+        if (buffer.compare(pos, 4, "<!--") == 0) {
+            skipUntil("-->");
+            continue;
+        }
+        if (buffer.compare(pos, 2, "<?") == 0) {
+            skipUntil("?>");
+            continue;
+        }
+        if (ensure(9) && buffer.compare(pos, 9, "<![CDATA[") == 0) {
+            pos += 9;
+            for (;;) {
+                size_t found = buffer.find("]]>", pos);
+                if (found != std::string::npos) {
+                    textValue.assign(buffer, pos, found - pos);
+                    pos = found + 3;
+                    return Event::Text;
+                }
+                if (!refill()) throw std::runtime_error("xml: unterminated CDATA");
+            }
+        }
+        if (buffer.compare(pos, 2, "<!") == 0) {
+            skipUntil(">");
+            continue;
+        }
+
+        size_t end = findTagEnd();
+        bool closing = buffer[pos + 1] == '/';
+        parseTag(end);
+        return closing ? Event::EndElement : Event::StartElement;
+    }
+}
+
+const std::string* XmlReader::attribute(std::string_view localName) const {
+    for (size_t i = 0; i < attributeCount; ++i) {
+        if (attributes[i].name == localName) return &attributes[i].value;
+    }
+    return nullptr;
+}
+
+void XmlReader::skipElement() {
+    int depth = 1;
+    while (depth > 0) {
+        switch (next()) {
+        case Event::StartElement: ++depth; break;
+        case Event::EndElement: --depth; break;
+        case Event::End: return;
+        default: break;
+        }
+    }
+}
+
+// ============================ XlsxWorkbook ============================
+
+XlsxWorkbook::XlsxWorkbook(const std::filesystem::path& path, bool loadShared)
+    : zip(path), activeIndex(0), date1904(false), sharedLoaded(false), stylesLoaded(false) {
+    std::string workbookPath = "xl/workbook.xml";
+    for (auto& [id, rel] : ReadRelationships(zip, "")) {
+        if (EndsWith(rel.type, "/officeDocument")) workbookPath = rel.target;
+    }
+    loadWorkbook(workbookPath);
+
+    if (loadShared) loadSharedParts();
+}
+
+void XlsxWorkbook::loadSharedParts(bool withStyles) {
+    if (sharedLoaded) return;
+    sharedLoaded = true;
+    stylesLoaded = withStyles;
+
+    if (!sharedStringsPath.empty()) loadSharedStrings(sharedStringsPath);
+    if (withStyles && !stylesPath.empty()) loadStyles(stylesPath);
+
+    if (cellFormats.empty()) {
+        cellFormats.push_back(xlnt::number_format::general());
+        generalFormats.push_back(true);
+        dateFormats.push_back(false);
+    }
+}
+
+uint64_t XlsxWorkbook::sharedPartsSize() const {
+    uint64_t size = 0;
+    for (const std::string* partPath : { &sharedStringsPath, &stylesPath }) {
+        if (partPath == &stylesPath && !stylesLoaded) continue;
+        const ZipEntry* entry = partPath->empty() ? nullptr : zip.find(*partPath);
+        if (entry) size += entry->uncompressedSize;
+    }
+    return size;
+}
+
+uint64_t XlsxWorkbook::sheetFingerprint(size_t sheetIndex, bool withStyles) const {
+    Hash64 hasher;
+    auto addPart = [&](const std::string& partPath) {
+        const ZipEntry* entry = partPath.empty() ? nullptr : zip.find(partPath);
+        uint64_t fields[2] = { entry ? entry->crc32 : 0, entry ? entry->uncompressedSize : 0 };
+        hasher.update(partPath.data(), partPath.size() + 1);
+        hasher.update(fields, sizeof(fields));
+    };
+    addPart(sheetList[sheetIndex].path);
+    addPart(sharedStringsPath);
+    if (withStyles) addPart(stylesPath);
+    hasher.update(&date1904, sizeof(date1904));
+    return hasher.digest();
+}
+
+XlsxWorkbook::~XlsxWorkbook() = default;
+
+void XlsxWorkbook::loadWorkbook(const std::string& workbookPath) {
+    auto relationships = ReadRelationships(zip, workbookPath);
+
+    // activeTab<sheets><sheet>ţ<sheet>Ҳռλlistedÿ<sheet>sheetListе±
+    const size_t kSkipped = SIZE_MAX;
+    size_t activeTab = 0;
+    std::vector<size_t> listed;
+
+    XmlReader xml(zip.open(workbookPath));
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event != XmlReader::Event::StartElement) continue;
+
+        if (xml.name() == "workbookPr") {
+            date1904 = IsTrue(xml.attribute("date1904"));
+        } else if (xml.name() == "workbookView") {
+            const std::string* tab = xml.attribute("activeTab");
+            if (tab) activeTab = std::strtoul(tab->c_str(), nullptr, 10);
+        } else if (xml.name() == "sheet") {
+            listed.push_back(kSkipped);
+            const std::string* name = xml.attribute("name");
+            const std::string* id = xml.attribute("id");
+            if (!name || !id) continue;
+            auto it = relationships.find(*id);
+            if (it == relationships.end()) continue;
+            listed.back() = sheetList.size();
+            sheetList.push_back(XlsxSheetInfo{ *name, it->second.target });
+        }
+    }
+
+    if (sheetList.empty()) {
+        throw std::runtime_error("xlsx: workbook has no sheets");
+    }
+    // <sheet>Խʱȡһ
+    activeIndex = activeTab < listed.size() && listed[activeTab] != kSkipped ? listed[activeTab] : 0;
+
+    for (auto& [id, rel] : relationships) {
+        if (EndsWith(rel.type, "/sharedStrings")) sharedStringsPath = rel.target;
+        else if (EndsWith(rel.type, "/styles")) stylesPath = rel.target;
+    }
+}
+
+/**
+ * ַ<si>ֱӵ<t>ı<r><t>ƴӣע<rPh>
+ */
+void XlsxWorkbook::loadSharedStrings(const std::string& partPath) {
+    if (!zip.find(partPath)) return;
+
+    XmlReader xml(zip.open(partPath));
+    bool inText = false;
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event == XmlReader::Event::StartElement) {
+            if (xml.name() == "sst") {
+                const std::string* unique = xml.attribute("uniqueCount");
+                if (unique) sharedStringList.reserve(std::strtoul(unique->c_str(), nullptr, 10));
+            } else if (xml.name() == "t") {
+                inText = true;
+            } else if (xml.name() == "rPh") {
+                xml.skipElement();
+            }
+        } else if (event == XmlReader::Event::EndElement) {
+            if (xml.name() == "t") inText = false;
+            else if (xml.name() == "si") sharedStringList.finish();
+        } else if (event == XmlReader::Event::Text && inText) {
+            sharedStringList.append(xml.text());
+        }
+    }
+}
+
+/**
+ * ֻȡָʽ<numFmts>Զʽ<cellXfs>ÿxfnumFmtId
+ */
+void XlsxWorkbook::loadStyles(const std::string& partPath) {
+    if (!zip.find(partPath)) return;
+
+    std::unordered_map<size_t, std::string> customFormats;
+    std::vector<size_t> xfFormatIds;
+    bool inCellXfs = false;
+
+    XmlReader xml(zip.open(partPath));
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event == XmlReader::Event::StartElement) {
+            if (xml.name() == "numFmt") {
+                const std::string* id = xml.attribute("numFmtId");
+                const std::string* code = xml.attribute("formatCode");
+                if (id && code) customFormats[std::strtoul(id->c_str(), nullptr, 10)] = *code;
+            } else if (xml.name() == "cellXfs") {
+                inCellXfs = true;
+            } else if (xml.name() == "xf" && inCellXfs) {
+                const std::string* id = xml.attribute("numFmtId");
+                xfFormatIds.push_back(id ? std::strtoul(id->c_str(), nullptr, 10) : 0);
+                xml.skipElement();
+            } else if (xml.name() == "cellStyleXfs" || xml.name() == "fonts" || xml.name() == "fills" ||
+                       xml.name() == "borders" || xml.name() == "dxfs") {
+                xml.skipElement();
+            }
+        } else if (event == XmlReader::Event::EndElement && xml.name() == "cellXfs") {
+            inCellXfs = false;
+        }
+    }
+
+    cellFormats.reserve(xfFormatIds.size());
+    for (size_t id : xfFormatIds) {
+        auto custom = customFormats.find(id);
+        if (custom != customFormats.end()) {
+            cellFormats.emplace_back(custom->second, id);
+            generalFormats.push_back(false);
+        } else if (id != 0 && xlnt::number_format::is_builtin_format(id)) {
+            cellFormats.push_back(xlnt::number_format::from_builtin_id(id));
+            generalFormats.push_back(false);
+        } else {
+            cellFormats.push_back(xlnt::number_format::general());
+            generalFormats.push_back(true);
+        }
+        dateFormats.push_back(cellFormats.back().is_date_format());
+    }
+}
+
+const xlnt::number_format& XlsxWorkbook::numberFormat(uint32_t style) const {
+    return cellFormats[style < cellFormats.size() ? style : 0];
+}
+
+bool XlsxWorkbook::isGeneralStyle(uint32_t style) const {
+    return generalFormats[style < generalFormats.size() ? style : 0];
+}
+
+bool XlsxWorkbook::isDateStyle(uint32_t style) const {
+    return dateFormats[style < dateFormats.size() ? style : 0];
+}
+
+std::string XlsxWorkbook::formatCell(const XlsxCell& cell) const {
+    std::pmr::string out;
+    formatCell(cell, out);
+    return std::string(out);
+}
+
+void XlsxWorkbook::formatCell(const XlsxCell& cell, std::pmr::string& out) const {
+    uint32_t style = cell.style < cellFormats.size() ? cell.style : 0;
+
+    switch (cell.type) {
+    case XlsxCellType::Empty:
+        out.clear();
+        break;
+    case XlsxCellType::Number:
+        out = numberFormat(style).format(std::strtod(cell.value.c_str(), nullptr),
+            date1904 ? xlnt::calendar::mac_1904 : xlnt::calendar::windows_1900);
+        break;
+    case XlsxCellType::Boolean:
+        out = cell.value == "0" || cell.value.empty() ? "FALSE" : "TRUE";
+        break;
+    case XlsxCellType::SharedString: {
+        size_t index = std::strtoul(cell.value.c_str(), nullptr, 10);
+        std::string_view text = index < sharedStringList.size() ? sharedStringList[index] : std::string_view(cell.value);
+        if (generalFormats[style]) out.assign(text);
+        else out = numberFormat(style).format(std::string(text));
+        break;
+    }
+    default:
+        if (generalFormats[style]) out.assign(cell.value);
+        else out = numberFormat(style).format(cell.value);
+        break;
+    }
+}
+
+void XlsxWorkbook::rawValue(const XlsxCell& cell, std::pmr::string& out) const {
+    switch (cell.type) {
+    case XlsxCellType::Empty:
+        out.clear();
+        break;
+    case XlsxCellType::Boolean:
+        out = cell.value == "0" || cell.value.empty() ? "FALSE" : "TRUE";
+        break;
+    case XlsxCellType::SharedString: {
+        size_t index = std::strtoul(cell.value.c_str(), nullptr, 10);
+        out.assign(index < sharedStringList.size() ? sharedStringList[index] : std::string_view(cell.value));
+        break;
+    }
+    default:
+        out.assign(cell.value);
+        break;
+    }
+}
+
+// ============================ XlsxRowExtractor ============================
+
+XlsxRowExtractor::XlsxRowExtractor(const XlsxWorkbook& workbook, size_t columns, bool raw, std::pmr::memory_resource* memory)
+    : workbook(workbook), raw(raw), values(memory), views(memory), sharedIndices(memory), kinds(memory), numbers(memory), touched(memory) {
+    setColumns(columns);
+    touched.reserve(columns);
+}
+
+void XlsxRowExtractor::setColumns(size_t columns) {
+    values.resize(columns);
+    views.resize(columns);
+    sharedIndices.resize(columns, kNotShared);
+    kinds.resize(columns, XlsxValueKind::Empty);
+    numbers.resize(columns);
+}
+
+void XlsxRowExtractor::extract(const XlsxRow* row, bool typed) {
+    for (uint32_t column : touched) {
+        if (column < views.size()) {
+            views[column] = std::string_view();
+            sharedIndices[column] = kNotShared;
+            kinds[column] = XlsxValueKind::Empty;
+        }
+    }
+    touched.clear();
+    if (!row) return;
+
+    const XlsxSharedStrings& sharedStrings = workbook.sharedStrings();
+    for (auto& cell : *row) {
+        if (cell.column == 0 || cell.column > views.size() || cell.type == XlsxCellType::Empty) continue;
+        uint32_t column = cell.column - 1;
+        std::pmr::string& value = values[column];
+        touched.push_back(column);
+
+        if (typed && cell.type == XlsxCellType::Boolean) {
+            views[column] = cell.value == "0" || cell.value.empty() ? "false" : "true";
+            kinds[column] = XlsxValueKind::Boolean;
+            continue;
+        }
+        if (typed && cell.type == XlsxCellType::Number && !workbook.isDateStyle(cell.style) && ShortestNumber(cell.value, value, numbers[column])) {
+            views[column] = value;
+            kinds[column] = XlsxValueKind::Number;
+            continue;
+        }
+
+        kinds[column] = XlsxValueKind::String;
+        if (cell.type == XlsxCellType::SharedString && (raw || workbook.isGeneralStyle(cell.style))) {
+            size_t index = std::strtoul(cell.value.c_str(), nullptr, 10);
+            if (index < sharedStrings.size()) {
+                views[column] = sharedStrings[index];
+                sharedIndices[column] = static_cast<uint32_t>(index);
+                continue;
+            }
+        }
+        if (raw) workbook.rawValue(cell, value);
+        else workbook.formatCell(cell, value);
+        views[column] = value;
+    }
+}
+
+// ============================ XlsxHeader ============================
+
+void XlsxHeader::build(const XlsxRowExtractor& extractor) {
+    keys.clear();
+    fields.clear();
+    std::unordered_map<std::string_view, size_t> firstField;
+
+    for (size_t col_index = 0; col_index < extractor.columns(); ++col_index) {
+        keys.emplace_back(extractor.value(col_index));
+    }
+    for (size_t col_index = 0; col_index < keys.size(); ++col_index) {
+        auto [it, inserted] = firstField.emplace(keys[col_index], fields.size());
+        if (inserted) fields.push_back(Field{ col_index, col_index });
+        else fields[it->second].valueColumn = col_index;
+    }
+}
+
+// ============================ XlsxSheetReader ============================
+
+XlsxSheetReader::XlsxSheetReader(const XlsxWorkbook& workbook, size_t sheetIndex)
+    : xml(workbook.archive().open(workbook.sheets().at(sheetIndex).path)), lastRow(0), done(false) {
+    // <sheetData>Ϊֹ˳ȡ<dimension>
+    for (auto event = xml.next(); ; event = xml.next()) {
+        if (event == XmlReader::Event::End) {
+            done = true;
+            break;
+        }
+        if (event != XmlReader::Event::StartElement) continue;
+
+        if (xml.name() == "dimension") {
+            const std::string* ref = xml.attribute("ref");
+            if (ref) {
+                std::string_view range(*ref);
+                size_t colon = range.find(':');
+                std::string_view first = range.substr(0, colon);
+                std::string_view last = colon == std::string_view::npos ? first : range.substr(colon + 1);
+                dim.firstColumn = ColumnIndexFromReference(first);
+                dim.firstRow = RowIndexFromReference(first);
+                dim.lastColumn = ColumnIndexFromReference(last);
+                dim.lastRow = RowIndexFromReference(last);
+            }
+        } else if (xml.name() == "sheetData") {
+            break;
+        } else if (xml.name() == "sheetViews" || xml.name() == "cols" || xml.name() == "sheetPr") {
+            xml.skipElement();
+        }
+    }
+}
+
+bool XlsxSheetReader::nextRow(XlsxRow& row) {
+    while (!done) {
+        auto event = xml.next();
+        if (event == XmlReader::Event::End) break;
+        if (event == XmlReader::Event::EndElement && xml.name() == "sheetData") break;
+        if (event != XmlReader::Event::StartElement || xml.name() != "row") continue;
+
+        const std::string* r = xml.attribute("r");
+        row.index = r ? static_cast<uint32_t>(std::strtoul(r->c_str(), nullptr, 10)) : lastRow + 1;
+        // кŲļټкŲе޷˳ʽһʹñʧ
+        if (row.index <= lastRow) {
+            throw std::runtime_error("xlsx: row " + std::to_string(row.index) + " follows row " + std::to_string(lastRow));
+        }
+        row.count = 0;
+        lastRow = row.index;
+
+        uint32_t lastColumn = 0;
+        for (event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+            if (event == XmlReader::Event::EndElement && xml.name() == "row") break;
+            if (event != XmlReader::Event::StartElement || xml.name() != "c") continue;
+
+            if (row.count == row.cells.size()) row.cells.emplace_back();
+            XlsxCell& cell = row.cells[row.count++];
+            const std::string* ref = xml.attribute("r");
+            const std::string* style = xml.attribute("s");
+            cell.column = ref ? ColumnIndexFromReference(*ref) : lastColumn + 1;
+            cell.style = style ? static_cast<uint32_t>(std::strtoul(style->c_str(), nullptr, 10)) : 0;
+            cell.type = CellTypeFromAttribute(xml.attribute("t"));
+            lastColumn = cell.column;
+            readCell(cell);
+        }
+        return true;
+    }
+
+    done = true;
+    return false;
+}
+
+/**
+ * ȡ<c>Ԫأ<v>ֵ<is>ַ<f>ʽ
+ */
+void XlsxSheetReader::readCell(XlsxCell& cell) {
+    XlsxCellType type = cell.type;
+    bool hasValue = false;
+    bool inValue = false;
+    cell.value.clear();
+
+    for (auto event = xml.next(); event != XmlReader::Event::End; event = xml.next()) {
+        if (event == XmlReader::Event::StartElement) {
+            const std::string& name = xml.name();
+            if (name == "v" || name == "t") {
+                inValue = true;
+                hasValue = true;
+            } else if (name == "f" || name == "rPh" || name == "extLst") {
+                xml.skipElement();
+            }
+        } else if (event == XmlReader::Event::EndElement) {
+            const std::string& name = xml.name();
+            if (name == "c") break;
+            if (name == "v" || name == "t") inValue = false;
+        } else if (event == XmlReader::Event::Text && inValue) {
+            cell.value += xml.text();
+        }
+    }
+
+    cell.type = hasValue ? type : XlsxCellType::Empty;
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "zip_archive.h"
+
+namespace xlnt {
+class number_format;
+}
+
+// ============================ XML ȡ ============================
+
+/**
+ * ֻXMLȡֱӴzipĿDOM
+ * ԱպԪ<a/>βStartElementEndElement¼
+ */
+class XmlReader {
+public:
+    enum class Event { StartElement, EndElement, Text, End };
+
+    explicit XmlReader(std::unique_ptr<ZipEntryStream> stream);
+
+    Event next();
+
+    // Ԫȥռǰ׺
+    const std::string& name() const { return elementName; }
+    const std::string& text() const { return textValue; }
+    const std::string* attribute(std::string_view localName) const;
+
+    // ǰԪصʣݣStartElement֮
+    void skipElement();
+
+private:
+    struct Attribute {
+        std::string name;
+        std::string value;
+    };
+
+    bool refill();
+    bool ensure(size_t count);
+    size_t findTagEnd();
+    void parseTag(size_t end);
+    void skipUntil(std::string_view terminator);
+
+    std::unique_ptr<ZipEntryStream> stream;
+    std::string buffer;
+    size_t pos;
+    bool eof;
+    bool pendingEnd;
+
+    std::string elementName;
+    std::string textValue;
+    std::vector<Attribute> attributes;
+    size_t attributeCount;
+};
+
+// ============================  ============================
+
+/**
+ * ԪͣӦ<c t="...">
+ */
+enum class XlsxCellType : uint8_t {
+    Empty,
+    Number,
+    Boolean,
+    SharedString,
+    InlineString,
+    FormulaString,
+    Error,
+    Date
+};
+
+/**
+ * ͻʱһֵJSONе
+ */
+enum class XlsxValueKind : uint8_t {
+    Empty,
+    String,
+    Number,
+    Boolean
+};
+
+/**
+ * ԪԭʼֵΪ<v>ıַΪıַΪı
+ */
+struct XlsxCell {
+    uint32_t column = 0;
+    uint32_t style = 0;
+    XlsxCellType type = XlsxCellType::Empty;
+    std::string value;
+};
+
+/**
+ * һʵʴ洢ĵԪ񣬰cellsֻԱ֮临ַ
+ */
+struct XlsxRow {
+    uint32_t index = 0;
+    size_t count = 0;
+    std::vector<XlsxCell> cells;
+
+    const XlsxCell* begin() const { return cells.data(); }
+    const XlsxCell* end() const { return cells.data() + count; }
+};
+
+/**
+ * <dimension ref="A1:D100"/> ݷΧо1ʼ
+ */
+struct XlsxDimension {
+    uint32_t firstRow = 1;
+    uint32_t firstColumn = 1;
+    uint32_t lastRow = 0;
+    uint32_t lastColumn = 0;
+
+    size_t height() const { return lastRow >= firstRow ? lastRow - firstRow + 1 : 0; }
+    size_t width() const { return lastColumn >= firstColumn ? lastColumn - firstColumn + 1 : 0; }
+};
+
+/**
+ * ַȫıβӴһڴȡstring_viewΪÿһ
+ */
+class XlsxSharedStrings {
+public:
+    size_t size() const { return ends.size(); }
+    std::string_view operator[](size_t index) const {
+        size_t begin = index > 0 ? ends[index - 1] : 0;
+        return std::string_view(text).substr(begin, ends[index] - begin);
+    }
+
+    void reserve(size_t count) { ends.reserve(count); }
+    // ڽһ׷ııĶ׷ӣfinishΪһ
+    void append(std::string_view part) { text.append(part.data(), part.size()); }
+    void finish() { ends.push_back(text.size()); }
+
+private:
+    std::string text;
+    std::vector<size_t> ends;
+};
+
+struct XlsxSheetInfo {
+    std::string name;
+    std::string path;
+};
+
+/**
+ * Ԫݣбַָʽ
+ * ֻworkbook.xmlϵļsharedStrings.xmlstyles.xmlݽXlsxSheetReaderʽȡ
+ * loadSharedΪfalseʱȲַʽȷйҪתٵloadSharedParts
+ * ֻȡԭʼֵʱԲʽʱеԪ񶼰ʽ
+ */
+class XlsxWorkbook {
+public:
+    explicit XlsxWorkbook(const std::filesystem::path& path, bool loadShared = true);
+    ~XlsxWorkbook();
+
+    void loadSharedParts(bool withStyles = true);
+
+    const ZipArchive& archive() const { return zip; }
+    const std::vector<XlsxSheetInfo>& sheets() const { return sheetList; }
+    size_t activeSheet() const { return activeIndex; }
+    const XlsxSharedStrings& sharedStrings() const { return sharedStringList; }
+    // ѶȡsharedStrings.xmlstyles.xmlѹĴС
+    uint64_t sharedPartsSize() const;
+
+    // ָƣȡĿ¼﹤sharedStringsstylesCRC32Сѹκ
+    // withStylesΪfalseʱstylesֻ˸ʽĹָƲ
+    uint64_t sheetFingerprint(size_t sheetIndex, bool withStyles = true) const;
+
+    //  xlnt::cell::to_string() һ£ԪָʽȾ
+    std::string formatCell(const XlsxCell& cell) const;
+    void formatCell(const XlsxCell& cell, std::pmr::string& out) const;
+
+    // 洢ԭʼֵַȡеıֵΪTRUE/FALSEΪ<v>ԭģʽ
+    void rawValue(const XlsxCell& cell, std::pmr::string& out) const;
+
+    // ԪʽǷΪʽıԪԭ
+    bool isGeneralStyle(uint32_t style) const;
+
+    // ԪʽǷΪʱ䣻ͻʱ԰ʽȾΪַ
+    bool isDateStyle(uint32_t style) const;
+
+private:
+    void loadWorkbook(const std::string& workbookPath);
+    void loadSharedStrings(const std::string& partPath);
+    void loadStyles(const std::string& partPath);
+    const xlnt::number_format& numberFormat(uint32_t style) const;
+
+    ZipArchive zip;
+    std::vector<XlsxSheetInfo> sheetList;
+    size_t activeIndex;
+    bool date1904;
+    std::string sharedStringsPath;
+    std::string stylesPath;
+    bool sharedLoaded;
+    bool stylesLoaded;
+    XlsxSharedStrings sharedStringList;
+    std::vector<xlnt::number_format> cellFormats;
+    std::vector<bool> generalFormats;
+    std::vector<bool> dateFormats;
+};
+
+/**
+ * ʽȡнsheetN.xml
+ */
+class XlsxSheetReader {
+public:
+    XlsxSheetReader(const XlsxWorkbook& workbook, size_t sheetIndex);
+
+    // <sheetData>֮ǰ<dimension>ȱʧʱlastRow/lastColumnΪ0
+    const XlsxDimension& dimension() const { return dim; }
+
+    // ȡһ洢<row>кűǵʱ׳쳣
+    bool nextRow(XlsxRow& row);
+
+private:
+    void readCell(XlsxCell& cell);
+
+    XmlReader xml;
+    XlsxDimension dim;
+    uint32_t lastRow;
+    bool done;
+};
+
+/**
+ * ȡֻʵʴ洢ĵԪ񣬰кܻ
+ * ֮临ãÿֻһдУ洢ĵԪ
+ * ҪȾĹֱַָĹַ
+ */
+class XlsxRowExtractor {
+public:
+    static constexpr uint32_t kNotShared = UINT32_MAX;
+
+    // rawΪtrueʱȡ洢ԭʼֵָʽȾmemory
+    XlsxRowExtractor(const XlsxWorkbook& workbook, size_t columns, bool raw = false,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    size_t columns() const { return values.size(); }
+    void setColumns(size_t columns);
+
+    // rowΪձʾڱûд洢Ϊпֵ
+    // typedΪtrueʱָдΪ̵ʾֵΪtrue/false൥Ԫ԰ָʽȾΪַ
+    void extract(const XlsxRow* row, bool typed = false);
+
+    // column0ʼvalueһextract֮ǰЧ
+    std::string_view value(size_t column) const { return views[column]; }
+    XlsxValueKind kind(size_t column) const { return kinds[column]; }
+    // kindΪNumberʱֵ
+    double number(size_t column) const { return numbers[column]; }
+    bool hasValue(size_t column) const { return kinds[column] != XlsxValueKind::Empty; }
+    // ûκֵ
+    bool empty() const { return touched.empty(); }
+    // ֵԭȡԹַʱΪıţΪkNotShared
+    uint32_t sharedIndex(size_t column) const { return sharedIndices[column]; }
+
+private:
+    const XlsxWorkbook& workbook;
+    bool raw;
+    std::pmr::vector<std::pmr::string> values;  // Ⱦֵviewsַָ
+    std::pmr::vector<std::string_view> views;
+    std::pmr::vector<uint32_t> sharedIndices;
+    std::pmr::vector<XlsxValueKind> kinds;
+    std::pmr::vector<double> numbers;
+    std::pmr::vector<uint32_t> touched;
+};
+
+/**
+ * ͷһÿһеļакֱڳܻȡֵٰ
+ * fieldsдҵ˳Уظļֻڵһγֵλֵȡһ
+ */
+struct XlsxHeader {
+    struct Field {
+        size_t keyColumn;
+        size_t valueColumn;
+    };
+
+    std::vector<std::string> keys;
+    std::vector<Field> fields;
+
+    void build(const XlsxRowExtractor& extractor);
+    const std::string& key(const Field& field) const { return keys[field.keyColumn]; }
+};
+
+/**
+ * ĸתкţ"A" -> 1ֹּͣҲֱӴ"B12"
+ */
+uint32_t ColumnIndexFromReference(std::string_view reference);
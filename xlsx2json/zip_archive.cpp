@@ -0,0 +1,268 @@
+#include "zip_archive.h"
+#include "converter.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const uint32_t kLocalHeaderSignature = 0x04034b50;
+const uint32_t kCentralHeaderSignature = 0x02014b50;
+const uint32_t kEndOfCentralSignature = 0x06054b50;
+const uint32_t kZip64EndOfCentralSignature = 0x06064b50;
+const uint32_t kZip64LocatorSignature = 0x07064b50;
+const size_t kInputChunkSize = 64 * 1024;
+
+uint16_t ReadU16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadU64(const unsigned char* p) {
+    return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+void ReadAt(std::ifstream& file, uint64_t offset, void* buffer, size_t size) {
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(file.gcount()) != size) {
+        throw std::runtime_error("zip: unexpected end of file");
+    }
+}
+
+/**
+ * Ŀ¼¼zip64չֶ
+ */
+void ApplyZip64Extra(ZipEntry& entry, const unsigned char* extra, size_t size) {
+    size_t pos = 0;
+    while (pos + 4 <= size) {
+        uint16_t id = ReadU16(extra + pos);
+        uint16_t len = ReadU16(extra + pos + 2);
+        const unsigned char* data = extra + pos + 4;
+        if (pos + 4 + len > size) break;
+        if (id == 0x0001) {
+            size_t off = 0;
+            if (entry.uncompressedSize == 0xFFFFFFFF && off + 8 <= len) {
+                entry.uncompressedSize = ReadU64(data + off);
+                off += 8;
+            }
+            if (entry.compressedSize == 0xFFFFFFFF && off + 8 <= len) {
+                entry.compressedSize = ReadU64(data + off);
+                off += 8;
+            }
+            if (entry.localHeaderOffset == 0xFFFFFFFF && off + 8 <= len) {
+                entry.localHeaderOffset = ReadU64(data + off);
+            }
+            return;
+        }
+        pos += 4 + len;
+    }
+}
+
+} // namespace
+
+// ============================ ZipArchive ============================
+
+ZipArchive::ZipArchive(const std::filesystem::path& path) : archivePath(path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("zip: cannot open " + PathToUtf8(path));
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < 22) {
+        throw std::runtime_error("zip: file too small");
+    }
+
+    // ĩβ¼ 65535 ֽעͣӺǰǩ
+    size_t tailSize = static_cast<size_t>(std::min<uint64_t>(fileSize, 22 + 0xFFFF));
+    std::vector<unsigned char> tail(tailSize);
+    ReadAt(file, fileSize - tailSize, tail.data(), tailSize);
+
+    size_t eocd = std::string::npos;
+    for (size_t i = tailSize - 22 + 1; i-- > 0;) {
+        if (ReadU32(&tail[i]) == kEndOfCentralSignature) {
+            eocd = i;
+            break;
+        }
+    }
+    if (eocd == std::string::npos) {
+        throw std::runtime_error("zip: end of central directory not found");
+    }
+
+    uint64_t entryCount = ReadU16(&tail[eocd + 10]);
+    uint64_t directorySize = ReadU32(&tail[eocd + 12]);
+    uint64_t directoryOffset = ReadU32(&tail[eocd + 16]);
+
+    // zip64 鵵ʵֵ zip64 ĩβ¼
+    if (eocd >= 20 && ReadU32(&tail[eocd - 20]) == kZip64LocatorSignature) {
+        unsigned char record[56];
+        ReadAt(file, ReadU64(&tail[eocd - 20 + 8]), record, sizeof(record));
+        if (ReadU32(record) != kZip64EndOfCentralSignature) {
+            throw std::runtime_error("zip: bad zip64 end of central directory");
+        }
+        entryCount = ReadU64(record + 32);
+        directorySize = ReadU64(record + 40);
+        directoryOffset = ReadU64(record + 48);
+    }
+
+    std::vector<unsigned char> directory(static_cast<size_t>(directorySize));
+    ReadAt(file, directoryOffset, directory.data(), directory.size());
+
+    entryList.reserve(static_cast<size_t>(entryCount));
+    size_t pos = 0;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (pos + 46 > directory.size() || ReadU32(&directory[pos]) != kCentralHeaderSignature) {
+            throw std::runtime_error("zip: corrupt central directory");
+        }
+        const unsigned char* header = &directory[pos];
+        uint16_t nameLength = ReadU16(header + 28);
+        uint16_t extraLength = ReadU16(header + 30);
+        uint16_t commentLength = ReadU16(header + 32);
+        if (pos + 46 + nameLength + extraLength + commentLength > directory.size()) {
+            throw std::runtime_error("zip: corrupt central directory");
+        }
+
+        ZipEntry entry;
+        entry.method = ReadU16(header + 10);
+        entry.crc32 = ReadU32(header + 16);
+        entry.compressedSize = ReadU32(header + 20);
+        entry.uncompressedSize = ReadU32(header + 24);
+        entry.localHeaderOffset = ReadU32(header + 42);
+        entry.name.assign(reinterpret_cast<const char*>(header + 46), nameLength);
+        ApplyZip64Extra(entry, header + 46 + nameLength, extraLength);
+
+        entryList.push_back(std::move(entry));
+        pos += 46 + nameLength + extraLength + commentLength;
+    }
+}
+
+const ZipEntry* ZipArchive::find(const std::string& name) const {
+    for (auto& entry : entryList) {
+        if (entry.name == name) return &entry;
+    }
+    // ɹ߻дɷбܻǰбܣݴȽһ
+    for (auto& entry : entryList) {
+        std::string normalized = entry.name;
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        if (!normalized.empty() && normalized[0] == '/') normalized.erase(0, 1);
+        if (normalized == name) return &entry;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<ZipEntryStream> ZipArchive::open(const ZipEntry& entry) const {
+    return std::make_unique<ZipEntryStream>(*this, entry);
+}
+
+std::unique_ptr<ZipEntryStream> ZipArchive::open(const std::string& name) const {
+    const ZipEntry* entry = find(name);
+    if (!entry) {
+        throw std::runtime_error("zip: entry not found " + name);
+    }
+    return open(*entry);
+}
+
+// ============================ ZipEntryStream ============================
+
+struct ZipEntryStream::Inflater {
+    z_stream stream;
+};
+
+ZipEntryStream::ZipEntryStream(const ZipArchive& archive, const ZipEntry& entry)
+    : file(archive.path(), std::ios::binary), entry(entry), compressedLeft(entry.compressedSize), crc(0), finished(false) {
+    if (!file) {
+        throw std::runtime_error("zip: cannot open " + PathToUtf8(archive.path()));
+    }
+    if (entry.method != 0 && entry.method != 8) {
+        throw std::runtime_error("zip: unsupported compression method in " + entry.name);
+    }
+
+    unsigned char header[30];
+    ReadAt(file, entry.localHeaderOffset, header, sizeof(header));
+    if (ReadU32(header) != kLocalHeaderSignature) {
+        throw std::runtime_error("zip: bad local header for " + entry.name);
+    }
+    file.seekg(static_cast<std::streamoff>(entry.localHeaderOffset + 30 + ReadU16(header + 26) + ReadU16(header + 28)));
+
+    if (entry.method == 8) {
+        inflater = std::make_unique<Inflater>();
+        std::memset(&inflater->stream, 0, sizeof(inflater->stream));
+        // λʾûzlibͷԭʼdeflate
+        if (inflateInit2(&inflater->stream, -MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("zip: inflateInit failed");
+        }
+        input.resize(kInputChunkSize);
+    }
+}
+
+ZipEntryStream::~ZipEntryStream() {
+    if (inflater) {
+        inflateEnd(&inflater->stream);
+    }
+}
+
+/**
+ * ߶ۼCRC32ĿĩβʱĿ¼еֵȽϣضϻ𻵵ĿᵱXMLȥ
+ */
+size_t ZipEntryStream::read(char* buffer, size_t size) {
+    if (finished || size == 0) return 0;
+
+    if (!inflater) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(size, compressedLeft));
+        file.read(buffer, static_cast<std::streamsize>(count));
+        count = static_cast<size_t>(file.gcount());
+        if (count == 0 && compressedLeft > 0) {
+            throw std::runtime_error("zip: truncated entry " + entry.name);
+        }
+        compressedLeft -= count;
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer), static_cast<uInt>(count));
+        if (count == 0) finish();
+        return count;
+    }
+
+    z_stream& zs = inflater->stream;
+    zs.next_out = reinterpret_cast<Bytef*>(buffer);
+    zs.avail_out = static_cast<uInt>(std::min<size_t>(size, 0x7FFFFFFF));
+
+    while (zs.avail_out > 0) {
+        if (zs.avail_in == 0 && compressedLeft > 0) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(input.size(), compressedLeft));
+            file.read(input.data(), static_cast<std::streamsize>(count));
+            count = static_cast<size_t>(file.gcount());
+            if (count == 0) {
+                throw std::runtime_error("zip: truncated entry " + entry.name);
+            }
+            compressedLeft -= count;
+            zs.next_in = reinterpret_cast<Bytef*>(input.data());
+            zs.avail_in = static_cast<uInt>(count);
+        }
+
+        int ret = inflate(&zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            finished = true;
+            break;
+        }
+        if (ret != Z_OK && !(ret == Z_BUF_ERROR && zs.avail_in == 0 && compressedLeft > 0)) {
+            throw std::runtime_error("zip: inflate failed for " + entry.name);
+        }
+    }
+
+    size_t produced = size - zs.avail_out;
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer), static_cast<uInt>(produced));
+    if (finished) finish();
+    return produced;
+}
+
+void ZipEntryStream::finish() {
+    finished = true;
+    if (crc != entry.crc32) {
+        throw std::runtime_error("zip: CRC mismatch in " + entry.name);
+    }
+}
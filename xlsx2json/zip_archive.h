@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================ Zip ȡ ============================
+
+/**
+ * Ŀ¼еһ¼
+ */
+struct ZipEntry {
+    std::string name;
+    uint16_t method = 0;
+    uint32_t crc32 = 0;
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
+};
+
+class ZipArchive;
+
+/**
+ * ĿֻѹinflateڴռĿС޹
+ */
+class ZipEntryStream {
+public:
+    ZipEntryStream(const ZipArchive& archive, const ZipEntry& entry);
+    ~ZipEntryStream();
+
+    ZipEntryStream(const ZipEntryStream&) = delete;
+    ZipEntryStream& operator=(const ZipEntryStream&) = delete;
+
+    // ȡsizeֽڽѹݣ0ʾĿ¼CRC32ʱĩβ׳쳣
+    size_t read(char* buffer, size_t size);
+
+private:
+    struct Inflater;
+
+    void finish();
+
+    std::ifstream file;
+    ZipEntry entry;
+    uint64_t compressedLeft;
+    uint32_t crc;       // ѶݵCRC32
+    std::vector<char> input;
+    std::unique_ptr<Inflater> inflater;
+    bool finished;
+};
+
+/**
+ * Zip鵵ʱֻȡĿ¼
+ */
+class ZipArchive {
+public:
+    explicit ZipArchive(const std::filesystem::path& path);
+
+    const std::filesystem::path& path() const { return archivePath; }
+    const std::vector<ZipEntry>& entries() const { return entryList; }
+    const ZipEntry* find(const std::string& name) const;
+
+    std::unique_ptr<ZipEntryStream> open(const ZipEntry& entry) const;
+    std::unique_ptr<ZipEntryStream> open(const std::string& name) const;
+
+private:
+    std::filesystem::path archivePath;
+    std::vector<ZipEntry> entryList;
+};
@@ -1,11 +1,15 @@
 add_rules("mode.release")
 
 add_requires("xlnt")
-add_requires("imgui")
-add_requires("glfw")
-add_requires("glad")
-add_requires("jsoncpp")
+add_requires("zlib")
+if is_plat("windows") then
+    add_requires("imgui")
+    add_requires("glfw")
+    add_requires("glad")
+end
 
+-- 图形界面只支持Windows（OLE拖拽）
+if is_plat("windows") then
 target("xlsx2json")
     set_kind("binary")
     set_installdir("publish/xlsx2json")
@@ -15,8 +19,55 @@ target("xlsx2json")
     add_packages("imgui")
     add_packages("glfw")
     add_packages("glad")
-    add_packages("jsoncpp")
+    add_packages("zlib")
     add_links("ole32")
+end
+
+-- 无界面的批量转换，可在Linux构建机上运行
+target("xlsx2json-cli")
+    set_kind("binary")
+    set_installdir("publish/xlsx2json")
+    set_languages("cxx20")
+    add_files("cli/*.cpp")
+    add_files("xlsx2json/*.cpp|main.cpp|imgui_impl_*.cpp")
+    add_includedirs("xlsx2json")
+    add_packages("xlnt")
+    add_packages("zlib")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+-- 性能基准：生成不同形状的工作簿，统计转换耗时中位数与p95、峰值内存和输出大小
+target("xlsx2json-bench")
+    set_kind("binary")
+    set_default(false)
+    set_languages("cxx20")
+    add_files("bench/*.cpp")
+    add_files("xlsx2json/*.cpp|main.cpp|imgui_impl_*.cpp")
+    add_includedirs("xlsx2json")
+    add_packages("xlnt")
+    add_packages("zlib")
+    if is_plat("windows") then
+        add_syslinks("psapi")
+    end
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+-- 单元测试：xmake build xlsx2json-test && xmake run xlsx2json-test，在项目根目录下读取tests/data
+target("xlsx2json-test")
+    set_kind("binary")
+    set_default(false)
+    set_languages("cxx20")
+    set_rundir("$(projectdir)")
+    add_files("tests/*.cpp")
+    add_files("xlsx2json/*.cpp|main.cpp|imgui_impl_*.cpp")
+    add_includedirs("xlsx2json")
+    add_packages("xlnt")
+    add_packages("zlib")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
 -- If you want to known more usage about xmake, please see https://xmake.io
 --
 -- ## FAQ